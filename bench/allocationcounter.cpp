@@ -0,0 +1,129 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long> count(0);
+
+#ifdef __GLIBC__
+// Defining the malloc family here overrides it for every library in the
+// process. Every entry point that can hand out memory is counted, not just
+// the ones our own code calls.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    void *ptr = __libc_memalign(alignment, size);
+    if (!ptr)
+        return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+void *valloc(size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_pvalloc(size);
+}
+
+void free(void *ptr) throw() {
+    __libc_free(ptr);
+}
+}
+
+// A static libstdc++ need not call malloc by its public name, so operator
+// new is counted on its own.
+static void *countedNew(size_t size) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = __libc_malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new(size_t size) {
+    return countedNew(size);
+}
+
+void *operator new[](size_t size) {
+    return countedNew(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) throw() {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) throw() {
+    __libc_free(ptr);
+}
+
+void operator delete[](void *ptr) throw() {
+    __libc_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) throw() {
+    __libc_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) throw() {
+    __libc_free(ptr);
+}
+
+bool allocationCountingSupported() {
+    return true;
+}
+#else
+bool allocationCountingSupported() {
+    return false;
+}
+#endif
+
+unsigned long allocationCount() {
+    return count.load(std::memory_order_relaxed);
+}
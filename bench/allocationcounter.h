@@ -0,0 +1,11 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// Number of heap allocations made by the whole process so far, including
+// chipmunk's: every malloc family entry point and every operator new. Only
+// counts on glibc, where malloc can be interposed; elsewhere it stays at
+// zero.
+unsigned long allocationCount();
+bool allocationCountingSupported();
+
+#endif // ALLOCATIONCOUNTER_H
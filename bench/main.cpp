@@ -0,0 +1,317 @@
+#include "allocationcounter.h"
+#include "rendersnapshot.h"
+#include "replay.h"
+#include "resourcebundle.h"
+#include "triplebuffer.h"
+#include "world.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+enum Scenario {
+    ScenarioIdle,
+    ScenarioAttached,
+    ScenarioSpam,
+    ScenarioSnapshot,
+    ScenarioReplay,
+};
+
+static const char *scenarioNames[] = {
+    "idle",
+    "attached",
+    "spam",
+    "snapshot",
+    "replay",
+};
+
+static const int scenarioCount = sizeof(scenarioNames) / sizeof(scenarioNames[0]);
+
+struct BenchOptions {
+    int platformCount = 64;
+    int playerCount = 4;
+    int warmupSteps = 300;
+    int steps = 6000;
+    bool failOnAlloc = false;
+    Replay *replay = NULL;
+    std::string describeMap;
+};
+
+static int usage(const char *arg0) {
+    std::cerr << "Usage: " << arg0 << " [options] [scenario...]\n"
+                 "\n"
+                 "Scenarios: idle, attached, spam, snapshot, replay (default all but replay)\n"
+                 "\n"
+                 "Options:\n"
+                 "  --platforms <n>    platforms in the arena (default 64)\n"
+                 "  --players <n>      players in the arena (default 4)\n"
+                 "  --warmup <n>       steps to run before measuring (default 300)\n"
+                 "  --steps <n>        steps to measure (default 6000)\n"
+                 "  --replay <path>    recorded match for the replay scenario\n"
+                 "  --fail-on-alloc    exit with an error if a measured step allocates\n"
+                 "  --describe-map <key> print what loads from a map instead of benchmarking\n"
+                 "\n"
+                 "Prints one JSON object per scenario.\n";
+    return 1;
+}
+
+// A floor and a ceiling that claws can hook, with the remaining platforms
+// in a grid between them and the players spread along the floor.
+static void buildArena(World &world, const BenchOptions &options) {
+    float width = std::max(1920.0f, options.playerCount * 64.0f + 128.0f);
+    float height = 1080.0f;
+    ImageId img = ImgGraybox;
+
+    world.addPlatform(cpv(width / 2.0f, height - 24.0f), cpv(width, 48.0f), img, true);
+    if (options.platformCount > 1)
+        world.addPlatform(cpv(width / 2.0f, 16.0f), cpv(width, 32.0f), img, true);
+
+    int gridCount = options.platformCount - 2;
+    if (gridCount > 0) {
+        int cols = std::max(1, (int)ceilf(sqrtf(gridCount * 2.0f)));
+        int rows = (gridCount + cols - 1) / cols;
+        float cellWidth = width / cols;
+        float cellHeight = 500.0f / rows;
+        for (int i = 0; i < gridCount; i += 1) {
+            float x = cellWidth * (i % cols + 0.5f);
+            float y = 200.0f + cellHeight * (i / cols + 0.5f);
+            world.addPlatform(cpv(x, y), cpv(std::min(48.0f, cellWidth / 2.0f), 16.0f), img, true);
+        }
+    }
+
+    for (int i = 0; i < options.playerCount; i += 1) {
+        world.initPlayer(i, cpv(96.0f + i * 64.0f, height - 80.0f));
+    }
+}
+
+static void scenarioInput(Scenario scenario, int step, int playerIndex, PlayerInput &input) {
+    input.reset();
+    switch (scenario) {
+    case ScenarioIdle:
+        break;
+    case ScenarioAttached:
+        // one shot straight up, then hang there
+        input.yAxis = -1.0f;
+        input.btnFireGrapple = (step == 0);
+        break;
+    case ScenarioReplay:
+        break;
+    case ScenarioSpam:
+    case ScenarioSnapshot:
+        {
+            // fire, then unhook and reel back in, over and over
+            float angle = -M_PI / 2.0f + (playerIndex % 5 - 2) * 0.3f;
+            int phase = (step + playerIndex * 5) % 24;
+            input.xAxis = cosf(angle);
+            input.yAxis = sinf(angle);
+            input.btnFireGrapple = (phase < 2);
+            input.btnUnhookGrapple = (phase >= 8);
+            break;
+        }
+    }
+}
+
+// Prints a map's collision boxes and what the window would draw from it,
+// for checking that tile layers come through mapc and loadMap intact.
+static void describeMap(ResourceBundle *bundle, const std::string &key) {
+    World world(bundle);
+    world.loadMap(key);
+    MapLayout layout;
+    layout.capture(world);
+
+    std::cout << "{\"map\":\"" << key << "\"" <<
+                 ",\"players\":" << world.players.size() <<
+                 ",\"platforms\":" << layout.platforms.size() <<
+                 ",\"collision_boxes\":[";
+    bool first = true;
+    for (int i = 0; i < (int)world.platforms.size(); i += 1) {
+        const World::Platform *platform = world.platforms[i];
+        if (platform->image)
+            continue;
+        std::cout << (first ? "" : ",") << "[" << platform->pos.x << "," << platform->pos.y << "," <<
+                     platform->size.x << "," << platform->size.y << "]";
+        first = false;
+    }
+    int visibleTiles = 0;
+    for (int i = 0; i < (int)layout.tileLayers.size(); i += 1) {
+        const World::TileLayer &layer = layout.tileLayers[i];
+        for (int j = 0; j < (int)layer.tiles.size(); j += 1) {
+            if (layer.tiles[j])
+                visibleTiles += 1;
+        }
+    }
+    std::cout << "],\"tile_layers\":" << world.tileLayers.size() <<
+                 ",\"visible_tile_layers\":" << layout.tileLayers.size() <<
+                 ",\"visible_tiles\":" << visibleTiles << "}\n";
+}
+
+// Returns false if --fail-on-alloc is set and a measured step allocated.
+static bool runScenario(ResourceBundle *bundle, Scenario scenario, const BenchOptions &options) {
+    Replay *replay = options.replay;
+    World world(bundle);
+    if (scenario == ScenarioReplay)
+        world.loadMap(replay->mapKey);
+    else
+        buildArena(world, options);
+
+    int totalSteps = options.warmupSteps + options.steps;
+    if (scenario == ScenarioReplay)
+        totalSteps = std::min(totalSteps, replay->stepCount());
+    if (totalSteps <= options.warmupSteps) {
+        std::cerr << "replay is only " << replay->stepCount() << " steps, shorter than the warmup\n";
+        std::exit(1);
+    }
+
+    std::vector<unsigned char> state;
+    TripleBuffer<RenderSnapshot> snapshots;
+    std::vector<long long> stepNs;
+    stepNs.reserve(totalSteps - options.warmupSteps);
+    unsigned long allocations = 0;
+    int firstAllocatingStep = -1;
+
+    for (int step = 0; step < totalSteps; step += 1) {
+        // Everything the game's simulation thread does for an offline step
+        // counts: replay input, the step, and capturing and handing over the
+        // render snapshot. The window thread's side of a frame is drawing
+        // through SFML, which needs a window and a GL context, so it and
+        // online play are not covered.
+        unsigned long allocationsBefore = allocationCount();
+        if (scenario == ScenarioReplay) {
+            replay->playStep(&world);
+        } else {
+            for (int i = 0; i < (int)world.players.size(); i += 1) {
+                scenarioInput(scenario, step, i, world.playerState.input[i]);
+            }
+        }
+
+        // snapshot times a save and restore of the spam arena instead of
+        // the step after it
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (scenario == ScenarioSnapshot) {
+            world.saveState(state);
+            world.loadState(state);
+        } else {
+            world.step();
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        if (scenario == ScenarioSnapshot)
+            world.step();
+        snapshots.back().capture(world, end);
+        snapshots.publish();
+        snapshots.update();
+        unsigned long stepAllocations = allocationCount() - allocationsBefore;
+
+        if (step >= options.warmupSteps) {
+            stepNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            allocations += stepAllocations;
+            if (stepAllocations > 0 && firstAllocatingStep == -1)
+                firstAllocatingStep = step;
+        }
+    }
+
+    double totalNs = 0;
+    for (int i = 0; i < (int)stepNs.size(); i += 1) {
+        totalNs += stepNs[i];
+    }
+    std::vector<long long> sorted = stepNs;
+    std::sort(sorted.begin(), sorted.end());
+    int n = sorted.size();
+
+    std::cout << "{\"scenario\":\"" << scenarioNames[scenario] << "\"" <<
+                 ",\"platforms\":" << world.platforms.size() <<
+                 ",\"players\":" << world.players.size() <<
+                 ",\"steps\":" << n <<
+                 ",\"ns_mean\":" << (totalNs / n) <<
+                 ",\"ns_p50\":" << sorted[n / 2] <<
+                 ",\"ns_p90\":" << sorted[n * 90 / 100] <<
+                 ",\"ns_p99\":" << sorted[n * 99 / 100] <<
+                 ",\"ns_max\":" << sorted[n - 1];
+    if (allocationCountingSupported())
+        std::cout << ",\"allocs_per_step\":" << ((double)allocations / n);
+    else
+        std::cout << ",\"allocs_per_step\":null";
+    std::cout << "}\n";
+
+    if (options.failOnAlloc && firstAllocatingStep != -1) {
+        std::cerr << scenarioNames[scenario] << ": step " << firstAllocatingStep << " allocated, " <<
+                     allocations << " allocations in " << n << " steps\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char * argv[]) {
+    BenchOptions options;
+    std::vector<Scenario> scenarios;
+
+    for (int i = 1; i < argc; i += 1) {
+        const char *arg = argv[i];
+        if (i + 1 < argc && strcmp(arg, "--platforms") == 0) {
+            options.platformCount = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--players") == 0) {
+            options.playerCount = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--warmup") == 0) {
+            options.warmupSteps = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--steps") == 0) {
+            options.steps = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--replay") == 0) {
+            options.replay = new Replay();
+            options.replay->load(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--describe-map") == 0) {
+            options.describeMap = argv[++i];
+        } else if (strcmp(arg, "--fail-on-alloc") == 0) {
+            options.failOnAlloc = true;
+        } else {
+            int found = -1;
+            for (int j = 0; j < scenarioCount; j += 1) {
+                if (strcmp(arg, scenarioNames[j]) == 0)
+                    found = j;
+            }
+            if (found == -1)
+                return usage(argv[0]);
+            scenarios.push_back((Scenario)found);
+        }
+    }
+    if (options.steps <= 0 || options.platformCount < 1 || options.playerCount < 1)
+        return usage(argv[0]);
+
+    if (scenarios.empty()) {
+        for (int i = 0; i < scenarioCount; i += 1) {
+            if (i != ScenarioReplay)
+                scenarios.push_back((Scenario)i);
+        }
+    }
+    for (int i = 0; i < (int)scenarios.size(); i += 1) {
+        if (scenarios[i] == ScenarioReplay && !options.replay) {
+            std::cerr << "the replay scenario needs --replay <path>\n";
+            return 1;
+        }
+    }
+    if (options.failOnAlloc && !allocationCountingSupported()) {
+        std::cerr << "--fail-on-alloc: allocation counting is not supported on this platform\n";
+        return 1;
+    }
+
+    ResourceBundle bundle;
+    bundle.open("assets.bundle");
+
+    if (!options.describeMap.empty()) {
+        describeMap(&bundle, options.describeMap);
+        delete options.replay;
+        return 0;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < (int)scenarios.size(); i += 1) {
+        if (!runScenario(&bundle, scenarios[i], options))
+            ok = false;
+    }
+
+    delete options.replay;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+# Writes a header with an ImageId for every image that assets.json packs
+# into the spritesheet, so code names images by identifier and a misspelled
+# one fails to compile.
+#
+# cmake -DASSETS_JSON=<assets.json> -DOUTPUT=<assetids.h> -P AssetIds.cmake
+
+get_filename_component(ASSETS_DIR ${ASSETS_JSON} PATH)
+file(READ ${ASSETS_JSON} JSON)
+
+# images are only under textures; anything before it is plain files
+string(FIND "${JSON}" "textures:" TEXTURES_START)
+string(SUBSTRING "${JSON}" ${TEXTURES_START} -1 JSON)
+string(REGEX REPLACE "//[^\n]*" "" JSON "${JSON}")
+
+set(KEYS)
+
+string(REGEX MATCHALL "\"[^\"]+\":[ \t\r\n]*{[ \t\r\n]*path:" IMAGES "${JSON}")
+foreach(IMAGE ${IMAGES})
+  string(REGEX REPLACE "^\"([^\"]+)\".*" "\\1" KEY "${IMAGE}")
+  list(APPEND KEYS ${KEY})
+endforeach()
+
+set(SPACE "[ \t\r\n]*")
+string(REGEX MATCHALL
+  "path:${SPACE}\"[^\"]*\",${SPACE}glob:${SPACE}\"[^\"]*\",${SPACE}prefix:${SPACE}\"[^\"]*\""
+  GLOBS "${JSON}")
+foreach(GLOB_ENTRY ${GLOBS})
+  string(REGEX REPLACE "^path:${SPACE}\"([^\"]*)\".*" "\\1" GLOB_PATH "${GLOB_ENTRY}")
+  string(REGEX REPLACE ".*glob:${SPACE}\"([^\"]*)\".*" "\\1" GLOB_PATTERN "${GLOB_ENTRY}")
+  string(REGEX REPLACE ".*prefix:${SPACE}\"([^\"]*)\"$" "\\1" GLOB_PREFIX "${GLOB_ENTRY}")
+  if(NOT IS_ABSOLUTE ${GLOB_PATH})
+    set(GLOB_PATH "${ASSETS_DIR}/${GLOB_PATH}")
+  endif()
+  file(GLOB FILES RELATIVE ${GLOB_PATH} ${GLOB_PATH}/${GLOB_PATTERN})
+  foreach(FILE ${FILES})
+    list(APPEND KEYS "${GLOB_PREFIX}${FILE}")
+  endforeach()
+endforeach()
+
+list(REMOVE_DUPLICATES KEYS)
+list(SORT KEYS)
+
+set(ENUM "")
+set(KEY_STRINGS "")
+foreach(KEY ${KEYS})
+  # img/claw-attached.png -> ImgClawAttached
+  string(REGEX REPLACE "\\.[^./]*$" "" NAME "${KEY}")
+  string(REGEX MATCHALL "[A-Za-z0-9]+" PARTS "${NAME}")
+  set(ID "")
+  foreach(PART ${PARTS})
+    string(SUBSTRING ${PART} 0 1 FIRST)
+    string(SUBSTRING ${PART} 1 -1 REST)
+    string(TOUPPER ${FIRST} FIRST)
+    set(ID "${ID}${FIRST}${REST}")
+  endforeach()
+  set(ENUM "${ENUM}    ${ID},\n")
+  set(KEY_STRINGS "${KEY_STRINGS}    \"${KEY}\",\n")
+endforeach()
+
+# only touch the header when it changes, so editing assets.json does not
+# rebuild everything
+file(WRITE ${OUTPUT}.tmp
+"// Generated from assets.json by cmake/AssetIds.cmake. Do not edit.
+#ifndef ASSETIDS_H
+#define ASSETIDS_H
+
+// every image in the spritesheet, in key order
+enum ImageId {
+${ENUM}    ImageIdCount,
+};
+
+static const char *const imageKeys[ImageIdCount] = {
+${KEY_STRINGS}};
+
+#endif // ASSETIDS_H
+")
+configure_file(${OUTPUT}.tmp ${OUTPUT} COPYONLY)
+file(REMOVE ${OUTPUT}.tmp)
@@ -0,0 +1,38 @@
+# Plays the same random match offline and online between two peers on this
+# machine over a bad network, then checks that each peer's confirmed world
+# matched the offline one at every step.
+#
+# cmake -DGRAPPLE=<grapple> -P RollbackTest.cmake, from the build directory
+
+set(STEPS 600)
+set(NET_ARGS --net-latency 40 --net-jitter 30 --net-loss 0.1)
+
+execute_process(COMMAND ${GRAPPLE} --headless --steps ${STEPS} --checksums offline.txt
+  RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "offline run failed")
+endif()
+
+# the commands of one execute_process run at the same time
+execute_process(
+  COMMAND ${GRAPPLE} --headless --steps ${STEPS} --checksums side0.txt
+    --net-side 0 --net-port 7100 --net-peer 127.0.0.1:7101 ${NET_ARGS}
+  COMMAND ${GRAPPLE} --headless --steps ${STEPS} --checksums side1.txt
+    --net-side 1 --net-port 7101 --net-peer 127.0.0.1:7100 ${NET_ARGS}
+  RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "online run failed")
+endif()
+
+foreach(SIDE side0 side1)
+  file(STRINGS ${SIDE}.txt LINES)
+  list(LENGTH LINES COUNT)
+  if(NOT COUNT EQUAL STEPS)
+    message(FATAL_ERROR "${SIDE} confirmed ${COUNT} of ${STEPS} steps")
+  endif()
+  execute_process(COMMAND ${GRAPPLE} --diverge offline.txt ${SIDE}.txt
+    RESULT_VARIABLE RESULT)
+  if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "${SIDE} diverged from offline play")
+  endif()
+endforeach()
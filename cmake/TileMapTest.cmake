@@ -0,0 +1,21 @@
+# Loads assets/tmx/tiles.tmx through mapc and the bundle, then checks that
+# its tile layers came out as the solid cells merged into collision boxes,
+# with only the visible layers' tiles left to draw.
+#
+# cmake -DBENCH=<grapple_bench> -P TileMapTest.cmake, from the build directory
+
+# ground: a 2x2 block, a ledge and the floor. decor: three tiles with
+# solid=0. walls: a hidden column at either edge. The object layer adds one
+# drawn platform and two starts.
+set(EXPECTED "{\"map\":\"map/tiles.map\",\"players\":2,\"platforms\":1,\"collision_boxes\":[[928,352,64,64],[416,496,192,32],[640,752,1280,32],[16,368,32,736],[1264,368,32,736]],\"tile_layers\":3,\"visible_tile_layers\":2,\"visible_tiles\":53}")
+
+execute_process(COMMAND ${BENCH} --describe-map map/tiles.map
+  OUTPUT_VARIABLE OUTPUT
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+  RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "grapple_bench --describe-map failed")
+endif()
+if(NOT OUTPUT STREQUAL EXPECTED)
+  message(FATAL_ERROR "tiles.map loaded as\n  ${OUTPUT}\nexpected\n  ${EXPECTED}")
+endif()
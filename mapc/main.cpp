@@ -0,0 +1,254 @@
+#include "assetids.h"
+#include "mapformat.h"
+
+#include <tmxparser/Tmx.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+struct TileRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+struct CompiledMap {
+    MapHeader header;
+    std::vector<MapPlatform> platforms;
+    std::vector<MapStart> starts;
+    std::vector<MapTileLayer> tileLayers;
+    std::vector<std::vector<uint16_t> > tiles;
+};
+
+static int usage(const char *arg0) {
+    std::cerr << "Usage: " << arg0 << " <map.tmx> <out.map>\n"
+                 "\n"
+                 "Compiles a tiled map into the binary form the game loads.\n";
+    return 1;
+}
+
+// Images are checked here so a misspelled one fails the build rather than
+// the game.
+static int imageId(const std::string &img) {
+    for (int i = 0; i < ImageIdCount; i += 1) {
+        if (img.compare(imageKeys[i]) == 0)
+            return i;
+    }
+    std::cerr << "map uses an image that is not in assets.json: " << img << "\n";
+    std::exit(1);
+}
+
+static void addPlatform(CompiledMap &out, float x, float y, float width, float height, int image, bool canGrapple) {
+    MapPlatform platform;
+    platform.x = x;
+    platform.y = y;
+    platform.width = width;
+    platform.height = height;
+    platform.image = image;
+    platform.canGrapple = canGrapple;
+    out.platforms.push_back(platform);
+}
+
+// Covers every solid cell with rectangles: take the first uncovered cell in
+// reading order, widen it along the row as far as it goes, then grow it
+// down while the whole row below is solid and uncovered.
+static void mergeTiles(const std::vector<bool> &solid, int width, int height, std::vector<TileRect> &rects)
+{
+    std::vector<bool> covered(solid.size(), false);
+    for (int y = 0; y < height; y += 1) {
+        for (int x = 0; x < width; x += 1) {
+            if (!solid[y * width + x] || covered[y * width + x])
+                continue;
+
+            TileRect rect = {x, y, 1, 1};
+            while (rect.x + rect.width < width && solid[y * width + rect.x + rect.width] &&
+                   !covered[y * width + rect.x + rect.width])
+            {
+                rect.width += 1;
+            }
+            for (;;) {
+                int row = rect.y + rect.height;
+                if (row >= height)
+                    break;
+                bool full = true;
+                for (int i = rect.x; i < rect.x + rect.width && full; i += 1) {
+                    full = solid[row * width + i] && !covered[row * width + i];
+                }
+                if (!full)
+                    break;
+                rect.height += 1;
+            }
+
+            for (int row = rect.y; row < rect.y + rect.height; row += 1) {
+                for (int i = rect.x; i < rect.x + rect.width; i += 1) {
+                    covered[row * width + i] = true;
+                }
+            }
+            rects.push_back(rect);
+        }
+    }
+}
+
+// Tiles take their image from an "img" property on the tile, or else on
+// the tileset. Layers collide unless they have solid=0, and can be grappled
+// unless they have canGrapple=0.
+static void compileTileLayer(CompiledMap &out, const Tmx::Map &map, const Tmx::Layer *layer)
+{
+    MapTileLayer tileLayer;
+    tileLayer.width = layer->GetWidth();
+    tileLayer.height = layer->GetHeight();
+    tileLayer.visible = layer->IsVisible();
+    std::vector<uint16_t> tiles(tileLayer.width * tileLayer.height, mapNoImage);
+
+    std::map<unsigned, int> gidImages;
+    std::vector<bool> solid(tiles.size(), false);
+    for (int y = 0; y < (int)tileLayer.height; y += 1) {
+        for (int x = 0; x < (int)tileLayer.width; x += 1) {
+            int tilesetIndex = layer->GetTileTilesetIndex(x, y);
+            if (tilesetIndex == -1)
+                continue;
+
+            unsigned gid = layer->GetTileGid(x, y);
+            std::map<unsigned, int>::iterator it = gidImages.find(gid);
+            if (it == gidImages.end()) {
+                const Tmx::Tileset *tileset = map.GetTileset(tilesetIndex);
+                const Tmx::Tile *tile = tileset->GetTile(layer->GetTileId(x, y));
+                std::string img;
+                if (tile && tile->GetProperties().HasProperty("img"))
+                    img = tile->GetProperties().GetStringProperty("img");
+                else if (tileset->GetProperties().HasProperty("img"))
+                    img = tileset->GetProperties().GetStringProperty("img");
+                else {
+                    std::cerr << "tileset " << tileset->GetName() << " has no img property\n";
+                    std::exit(1);
+                }
+                it = gidImages.insert(std::make_pair(gid, imageId(img))).first;
+            }
+            tiles[y * tileLayer.width + x] = it->second;
+            solid[y * tileLayer.width + x] = true;
+        }
+    }
+    out.tileLayers.push_back(tileLayer);
+    out.tiles.push_back(tiles);
+
+    const Tmx::PropertySet &properties = layer->GetProperties();
+    if (!properties.GetIntProperty("solid", 1))
+        return;
+    bool canGrapple = !!properties.GetIntProperty("canGrapple", 1);
+
+    float tileWidth = map.GetTileWidth();
+    float tileHeight = map.GetTileHeight();
+    std::vector<TileRect> rects;
+    mergeTiles(solid, tileLayer.width, tileLayer.height, rects);
+    for (int i = 0; i < (int)rects.size(); i += 1) {
+        const TileRect &rect = rects[i];
+        float width = rect.width * tileWidth;
+        float height = rect.height * tileHeight;
+        addPlatform(out, rect.x * tileWidth + width / 2, rect.y * tileHeight + height / 2,
+                width, height, -1, canGrapple);
+    }
+}
+
+static void compileMap(CompiledMap &out, const Tmx::Map &map)
+{
+    for (int i = 0; i < map.GetNumLayers(); i += 1) {
+        compileTileLayer(out, map, map.GetLayer(i));
+    }
+    for (int i = 0; i < map.GetNumObjectGroups(); i += 1) {
+        const Tmx::ObjectGroup *objectGroup = map.GetObjectGroup(i);
+        for (int j = 0; j < objectGroup->GetNumObjects(); j += 1) {
+            const Tmx::Object *object = objectGroup->GetObject(j);
+            float width = object->GetWidth();
+            float height = object->GetHeight();
+            float x = object->GetX() + width / 2;
+            float y = object->GetY() + height / 2;
+            const Tmx::PropertySet &properties = object->GetProperties();
+
+            if (object->GetName().compare("Platform") == 0) {
+                int image = imageId(properties.GetStringProperty("img"));
+                bool canGrapple = !!properties.GetIntProperty("canGrapple", 1);
+                addPlatform(out, x, y, width, height, image, canGrapple);
+            } else if (object->GetName().compare("Start") == 0) {
+                MapStart start;
+                start.player = properties.GetIntProperty("player");
+                start.x = x;
+                start.y = y;
+                out.starts.push_back(start);
+            } else {
+                std::cerr << "unrecognized object name: " << object->GetName() << "\n";
+                std::exit(1);
+            }
+        }
+    }
+
+    // players are numbered from 0 with no gaps; duplicates are reported when
+    // the map loads
+    if ((int)out.starts.size() > mapMaxPlayers) {
+        std::cerr << "too many Start objects: " << out.starts.size() << ", at most "
+                  << mapMaxPlayers << "\n";
+        std::exit(1);
+    }
+    for (int i = 0; i < (int)out.starts.size(); i += 1) {
+        if (out.starts[i].player < 0 || out.starts[i].player >= (int)out.starts.size()) {
+            std::cerr << "bad player index in Start object: " << out.starts[i].player << "\n";
+            std::exit(1);
+        }
+    }
+
+    MapHeader &header = out.header;
+    memcpy(header.magic, mapMagic, sizeof(header.magic));
+    header.version = mapFormatVersion;
+    header.width = map.GetWidth() * map.GetTileWidth();
+    header.height = map.GetHeight() * map.GetTileHeight();
+    header.tileWidth = map.GetTileWidth();
+    header.tileHeight = map.GetTileHeight();
+    header.platformCount = out.platforms.size();
+    header.startCount = out.starts.size();
+    header.tileLayerCount = out.tileLayers.size();
+}
+
+static void writeMap(const CompiledMap &out, const char *path)
+{
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream) {
+        std::cerr << "unable to open " << path << " for writing\n";
+        std::exit(1);
+    }
+    stream.write((const char *)&out.header, sizeof(out.header));
+    if (!out.platforms.empty())
+        stream.write((const char *)&out.platforms[0], out.platforms.size() * sizeof(MapPlatform));
+    if (!out.starts.empty())
+        stream.write((const char *)&out.starts[0], out.starts.size() * sizeof(MapStart));
+    for (int i = 0; i < (int)out.tileLayers.size(); i += 1) {
+        stream.write((const char *)&out.tileLayers[i], sizeof(MapTileLayer));
+        if (!out.tiles[i].empty())
+            stream.write((const char *)&out.tiles[i][0], out.tiles[i].size() * sizeof(uint16_t));
+    }
+    if (!stream) {
+        std::cerr << "error writing " << path << "\n";
+        std::exit(1);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3)
+        return usage(argv[0]);
+
+    Tmx::Map map;
+    map.ParseFile(argv[1]);
+    if (map.HasError()) {
+        std::cerr << argv[1] << ": error parsing map: " << map.GetErrorText() << "\n";
+        return 1;
+    }
+
+    CompiledMap out;
+    compileMap(out, map);
+    writeMap(out, argv[2]);
+    return 0;
+}
@@ -31,6 +31,18 @@ Animation::Animation() : m_texture(NULL)
 void Animation::addFrame(sf::IntRect rect)
 {
     m_frames.push_back(rect);
+
+    float width = static_cast<float>(rect.width);
+    float height = static_cast<float>(rect.height);
+    float left = static_cast<float>(rect.left) + 0.0001f;
+    float right = left + width;
+    float top = static_cast<float>(rect.top);
+    float bottom = top + height;
+
+    m_quads.push_back(sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Vector2f(left, top)));
+    m_quads.push_back(sf::Vertex(sf::Vector2f(0.f, height), sf::Vector2f(left, bottom)));
+    m_quads.push_back(sf::Vertex(sf::Vector2f(width, height), sf::Vector2f(right, bottom)));
+    m_quads.push_back(sf::Vertex(sf::Vector2f(width, 0.f), sf::Vector2f(right, top)));
 }
 
 void Animation::setSpriteSheet(const sf::Texture& texture)
@@ -52,3 +64,8 @@ const sf::IntRect& Animation::getFrame(std::size_t n) const
 {
     return m_frames[n];
 }
+
+const sf::Vertex* Animation::getQuad(std::size_t n) const
+{
+    return &m_quads[n * 4];
+}
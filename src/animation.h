@@ -27,6 +27,7 @@
 #include <vector>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
 
 class Animation
 {
@@ -38,9 +39,12 @@ public:
     const sf::Texture* getSpriteSheet() const;
     std::size_t getSize() const;
     const sf::IntRect& getFrame(std::size_t n) const;
+    // four vertices in the frame's local space, built when it was added
+    const sf::Vertex* getQuad(std::size_t n) const;
 
 private:
     std::vector<sf::IntRect> m_frames;
+    std::vector<sf::Vertex> m_quads;
     const sf::Texture* m_texture;
 };
 
@@ -0,0 +1,144 @@
+#include "batchrunner.h"
+#include "inputsource.h"
+#include "resourcebundle.h"
+#include "workpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+// Worlds can step in parallel, but setting one up cannot: chipmunk numbers
+// shapes from a global counter, which each world resets and then counts up
+// from as its map loads.
+static std::mutex setupMutex;
+
+BatchRunner::BatchRunner() :
+    mapKey("map/basic.map"),
+    matches(100),
+    steps(60 * 60),
+    threads(0),
+    seed(1)
+{
+}
+
+int BatchRunner::start()
+{
+    ResourceBundle bundle;
+    bundle.open("assets.bundle");
+
+    std::vector<MatchResult> results(matches);
+    WorkPool pool(threads);
+    for (int i = 0; i < matches; i += 1) {
+        MatchResult &result = results[i];
+        pool.add([this, &bundle, i, &result]() {
+            runMatch(&bundle, i, result);
+        });
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    pool.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    long long totalSteps = (long long)matches * steps;
+    std::cout << matches << " matches of " << steps << " steps on " << pool.threadCount() <<
+                 " threads in " << elapsed.count() << "s (" << (totalSteps / elapsed.count()) <<
+                 " steps/s)\n";
+
+    double attaches = 0;
+    double jumps = 0;
+    double airborne = 0;
+    double meanSpeed = 0;
+    int minAttaches = matches ? results[0].attaches : 0;
+    int maxAttaches = minAttaches;
+    for (int i = 0; i < matches; i += 1) {
+        const MatchResult &result = results[i];
+        attaches += result.attaches;
+        jumps += result.jumps;
+        airborne += result.airborne;
+        meanSpeed += result.meanSpeed;
+        minAttaches = std::min(minAttaches, result.attaches);
+        maxAttaches = std::max(maxAttaches, result.attaches);
+    }
+    if (matches > 0) {
+        std::cout << "attaches per match: " << (attaches / matches) <<
+                     " (min " << minAttaches << ", max " << maxAttaches << ")\n" <<
+                     "jumps per match: " << (jumps / matches) << "\n" <<
+                     "airborne: " << (100.0 * airborne / matches) << "%\n" <<
+                     "mean speed: " << (meanSpeed / matches) << "\n";
+    }
+
+    if (!resultsPath.empty())
+        writeResults(results);
+    return 0;
+}
+
+void BatchRunner::runMatch(ResourceBundle *bundle, int index, MatchResult &result)
+{
+    World *world;
+    {
+        std::lock_guard<std::mutex> lock(setupMutex);
+        world = new World(bundle, tuning);
+        world->loadMap(mapKey);
+    }
+
+    result.seed = seed + index;
+    result.steps = steps;
+    result.attaches = 0;
+    result.jumps = 0;
+    long long airborneSteps = 0;
+    double speedSum = 0;
+
+    RandomInputSource input(result.seed);
+    const World::PlayerState &state = world->playerState;
+    int playerCount = world->players.size();
+    std::vector<World::ClawState> prevClawState(state.clawState);
+    std::vector<int> prevJumpFrameCount(state.jumpFrameCount);
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step += 1) {
+        for (int i = 0; i < playerCount; i += 1) {
+            input.getInput(step, i, world->playerState.input[i]);
+        }
+        world->step();
+
+        for (int i = 0; i < playerCount; i += 1) {
+            if (state.clawState[i] == World::ClawStateAttached && prevClawState[i] != World::ClawStateAttached)
+                result.attaches += 1;
+            if (state.jumpFrameCount[i] > 0 && prevJumpFrameCount[i] == 0)
+                result.jumps += 1;
+            if (state.footContacts[i] == 0)
+                airborneSteps += 1;
+            speedSum += cpvlength(world->players[i]->body->v);
+            prevClawState[i] = state.clawState[i];
+            prevJumpFrameCount[i] = state.jumpFrameCount[i];
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    long long playerSteps = (long long)steps * playerCount;
+    result.seconds = elapsed.count();
+    result.airborne = playerSteps ? (double)airborneSteps / playerSteps : 0.0;
+    result.meanSpeed = playerSteps ? speedSum / playerSteps : 0.0;
+
+    delete world;
+}
+
+void BatchRunner::writeResults(const std::vector<MatchResult> &results)
+{
+    std::ofstream out(resultsPath.c_str());
+    if (!out) {
+        std::cerr << "Unable to write results: " << resultsPath << "\n";
+        std::exit(1);
+    }
+
+    out << "seed,steps,seconds,attaches,jumps,airborne,mean_speed\n";
+    for (int i = 0; i < (int)results.size(); i += 1) {
+        const MatchResult &result = results[i];
+        out << result.seed << "," << result.steps << "," << result.seconds << "," <<
+               result.attaches << "," << result.jumps << "," << result.airborne << "," <<
+               result.meanSpeed << "\n";
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <string>
+#include <vector>
+
+#include "world.h"
+
+// Simulates many independent matches at once, each in its own World with
+// random input from its own seed, spread over a WorkPool. Prints a summary
+// of all matches at the end, for comparing tuning values.
+class BatchRunner
+{
+public:
+    BatchRunner();
+
+    std::string mapKey;
+    int matches;
+    int steps;
+    // 0 means one per hardware thread
+    int threads;
+    // match i uses seed + i
+    unsigned int seed;
+    Tuning tuning;
+    // when set, one CSV row per match is written here
+    std::string resultsPath;
+
+    int start();
+
+private:
+    struct MatchResult {
+        unsigned int seed;
+        int steps;
+        double seconds;
+        int attaches; // claws hooking onto something
+        int jumps;
+        double airborne; // fraction of player steps off the ground
+        double meanSpeed;
+    };
+
+    void runMatch(ResourceBundle *bundle, int index, MatchResult &result);
+    void writeResults(const std::vector<MatchResult> &results);
+};
+
+#endif // BATCHRUNNER_H
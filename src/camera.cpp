@@ -0,0 +1,90 @@
+#include "camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+// room around the outermost players
+static float playerMargin = 200.0f;
+// never zoom in further than this many world pixels per screen pixel
+static float minZoom = 0.5f;
+// how quickly the camera catches up, per second
+static float followRate = 4.0f;
+
+Camera::Camera() :
+    viewWidth(0.0f),
+    placed(false)
+{
+}
+
+void Camera::setViewportSize(float width, float height)
+{
+    viewportSize = sf::Vector2f(width, height);
+}
+
+void Camera::setArenaSize(float width, float height)
+{
+    arenaSize = sf::Vector2f(width, height);
+    placed = false;
+}
+
+void Camera::update(const RenderSnapshot &snapshot, float dt)
+{
+    float aspect = viewportSize.x / viewportSize.y;
+
+    sf::Vector2f targetCenter = arenaSize / 2.0f;
+    float targetWidth = std::max(arenaSize.x, arenaSize.y * aspect);
+    if (!snapshot.players.empty()) {
+        cpVect minPos = snapshot.players[0].pos;
+        cpVect maxPos = minPos;
+        for (int i = 1; i < (int)snapshot.players.size(); i += 1) {
+            cpVect pos = snapshot.players[i].pos;
+            minPos = cpv(std::min(minPos.x, pos.x), std::min(minPos.y, pos.y));
+            maxPos = cpv(std::max(maxPos.x, pos.x), std::max(maxPos.y, pos.y));
+        }
+        targetCenter = sf::Vector2f((minPos.x + maxPos.x) / 2.0f, (minPos.y + maxPos.y) / 2.0f);
+        float width = maxPos.x - minPos.x + playerMargin * 2.0f;
+        float height = maxPos.y - minPos.y + playerMargin * 2.0f;
+        // zooming out past the whole arena shows nothing more
+        float wholeArena = std::max(arenaSize.x, arenaSize.y * aspect);
+        targetWidth = std::min(std::max(width, height * aspect), wholeArena);
+        targetWidth = std::max(targetWidth, viewportSize.x * minZoom);
+    }
+
+    if (placed) {
+        float t = 1.0f - expf(-followRate * dt);
+        center += (targetCenter - center) * t;
+        viewWidth += (targetWidth - viewWidth) * t;
+    } else {
+        center = targetCenter;
+        viewWidth = targetWidth;
+        placed = true;
+    }
+
+    // keep the arena's edges at the screen's edges, or centered when the
+    // view is bigger than the arena
+    sf::Vector2f size(viewWidth, viewWidth / aspect);
+    sf::Vector2f viewCenter = center;
+    if (size.x >= arenaSize.x)
+        viewCenter.x = arenaSize.x / 2.0f;
+    else
+        viewCenter.x = std::max(size.x / 2.0f, std::min(viewCenter.x, arenaSize.x - size.x / 2.0f));
+    if (size.y >= arenaSize.y)
+        viewCenter.y = arenaSize.y / 2.0f;
+    else
+        viewCenter.y = std::max(size.y / 2.0f, std::min(viewCenter.y, arenaSize.y - size.y / 2.0f));
+
+    view.setSize(size);
+    view.setCenter(viewCenter);
+}
+
+const sf::View &Camera::getView() const
+{
+    return view;
+}
+
+sf::FloatRect Camera::getVisibleRect() const
+{
+    sf::Vector2f size = view.getSize();
+    sf::Vector2f corner = view.getCenter() - size / 2.0f;
+    return sf::FloatRect(corner.x, corner.y, size.x, size.y);
+}
@@ -0,0 +1,33 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SFML/Graphics.hpp>
+
+#include "rendersnapshot.h"
+
+// Follows the players around the arena, zooming out to keep all of them in
+// frame and never showing past the arena's edges when it can avoid it.
+class Camera
+{
+public:
+    Camera();
+
+    void setViewportSize(float width, float height);
+    void setArenaSize(float width, float height);
+
+    // Jumps straight to the players the first time, then eases towards them.
+    void update(const RenderSnapshot &snapshot, float dt);
+
+    const sf::View &getView() const;
+    sf::FloatRect getVisibleRect() const;
+
+private:
+    sf::Vector2f viewportSize;
+    sf::Vector2f arenaSize;
+    sf::Vector2f center;
+    float viewWidth;
+    bool placed;
+    sf::View view;
+};
+
+#endif // CAMERA_H
@@ -0,0 +1,105 @@
+#include "checksumlog.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+struct ChecksumLine {
+    int step;
+    unsigned long long world;
+    std::vector<unsigned long long> players;
+};
+
+void ChecksumLog::open(const std::string &path)
+{
+    out.open(path.c_str());
+    if (!out) {
+        std::cerr << "Unable to write checksums: " << path << "\n";
+        std::exit(1);
+    }
+    out << std::hex;
+}
+
+void ChecksumLog::record(const World &world)
+{
+    out << std::dec << world.stepIndex << std::hex << " " << world.checksum();
+    for (int i = 0; i < (int)world.players.size(); i += 1) {
+        out << " " << world.playerChecksum(i);
+    }
+    out << "\n";
+}
+
+static bool readLine(std::ifstream &in, const std::string &path, ChecksumLine &line)
+{
+    std::string text;
+    if (!std::getline(in, text))
+        return false;
+    std::istringstream ss(text);
+    if (!(ss >> std::dec >> line.step >> std::hex >> line.world)) {
+        std::cerr << path << ": expected <step> <world checksum> ...\n";
+        std::exit(1);
+    }
+    line.players.clear();
+    unsigned long long player;
+    while (ss >> player) {
+        line.players.push_back(player);
+    }
+    return true;
+}
+
+static void openLog(std::ifstream &in, const std::string &path)
+{
+    in.open(path.c_str());
+    if (!in) {
+        std::cerr << "Unable to open checksums: " << path << "\n";
+        std::exit(1);
+    }
+}
+
+int findDivergence(const std::string &pathA, const std::string &pathB)
+{
+    std::ifstream inA;
+    std::ifstream inB;
+    openLog(inA, pathA);
+    openLog(inB, pathB);
+
+    ChecksumLine a;
+    ChecksumLine b;
+    int compared = 0;
+    while (true) {
+        bool haveA = readLine(inA, pathA, a);
+        bool haveB = readLine(inB, pathB, b);
+        if (!haveA && !haveB)
+            break;
+        if (haveA != haveB) {
+            // one run stopped early, so the first step it lacks is where
+            // they part
+            std::cout << "diverged at step " << (haveA ? a.step : b.step) << ": " <<
+                         (haveA ? pathB : pathA) << " ends before it\n";
+            return 1;
+        }
+        if (a.step != b.step) {
+            std::cerr << "step " << a.step << " in " << pathA << " lines up with step " << b.step <<
+                         " in " << pathB << "; start both runs at the same step\n";
+            return 1;
+        }
+        if (a.world != b.world || a.players != b.players) {
+            std::cout << "diverged at step " << a.step;
+            if (a.players.size() != b.players.size()) {
+                std::cout << ": " << a.players.size() << " players against " << b.players.size() << "\n";
+                return 1;
+            }
+            std::cout << ", players";
+            for (int i = 0; i < (int)a.players.size(); i += 1) {
+                if (a.players[i] != b.players[i])
+                    std::cout << " " << i;
+            }
+            std::cout << "\n";
+            return 1;
+        }
+        compared += 1;
+    }
+    std::cout << "no divergence in " << compared << " steps\n";
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef CHECKSUMLOG_H
+#define CHECKSUMLOG_H
+
+#include <fstream>
+#include <string>
+
+#include "world.h"
+
+// Writes the world's checksums after every step, one line per step:
+//
+//     <step> <world> <player 0> <player 1> ...
+//
+// in hex, so two runs can be compared with findDivergence.
+class ChecksumLog
+{
+public:
+    void open(const std::string &path);
+    void record(const World &world);
+
+private:
+    std::ofstream out;
+};
+
+// Compares two checksum logs and prints the first step where they differ,
+// and which players. A log that ends first differs at its first missing
+// step. Returns 0 only if the logs are the same length and agree throughout.
+int findDivergence(const std::string &pathA, const std::string &pathB);
+
+#endif // CHECKSUMLOG_H
@@ -0,0 +1,160 @@
+#include "framepacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+static const char *modeNames[] = {
+    "vsync",
+    "uncapped",
+    "cap",
+    "adaptive",
+};
+static const int modeCount = sizeof(modeNames) / sizeof(modeNames[0]);
+
+// sleeping can overshoot by about a scheduler tick, so the last stretch
+// before a capped frame is spun instead
+static int spinMicroseconds = 1500;
+// a frame this many intervals long missed at least one refresh
+static float missedIntervals = 1.5f;
+// adaptive turns vsync off after this many late frames out of the last
+// lateWindow, and back on after onTimeFrames on time in a row
+static int lateFrames = 3;
+static int lateWindow = 60;
+static int onTimeFrames = 120;
+
+const char *pacingModeName(PacingMode mode)
+{
+    return modeNames[mode];
+}
+
+bool parsePacingMode(const char *name, PacingMode &mode)
+{
+    for (int i = 0; i < modeCount; i += 1) {
+        if (strcmp(name, modeNames[i]) == 0) {
+            mode = (PacingMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+FramePacer::FramePacer() :
+    window(NULL),
+    mode(PacingVsync),
+    vsync(false),
+    hasPresented(false),
+    frameMs(statsWindow),
+    nextFrame(0),
+    frameCount(0),
+    missed(0),
+    recentLateIndex(0),
+    recentLateCount(0),
+    onTimeStreak(0)
+{
+}
+
+void FramePacer::start(sf::Window &window, PacingMode mode, int fps)
+{
+    this->window = &window;
+    this->mode = mode;
+    interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    vsync = (mode == PacingVsync || mode == PacingAdaptive);
+    window.setVerticalSyncEnabled(vsync);
+    nextPresent = Clock::now();
+    hasPresented = false;
+    recentLate.assign(lateWindow, false);
+    recentLateIndex = 0;
+    recentLateCount = 0;
+    onTimeStreak = 0;
+}
+
+void FramePacer::waitToPresent()
+{
+    if (mode != PacingCapped)
+        return;
+
+    nextPresent += interval;
+    Clock::time_point now = Clock::now();
+    // already late: start counting again from here rather than rushing
+    // frames out to catch up
+    if (nextPresent < now) {
+        nextPresent = now;
+        return;
+    }
+    Clock::time_point spinFrom = nextPresent - std::chrono::microseconds(spinMicroseconds);
+    if (now < spinFrom)
+        std::this_thread::sleep_until(spinFrom);
+    while (Clock::now() < nextPresent) {
+    }
+}
+
+void FramePacer::presented()
+{
+    Clock::time_point now = Clock::now();
+    if (!hasPresented) {
+        hasPresented = true;
+        lastPresent = now;
+        return;
+    }
+
+    Clock::duration frameTime = now - lastPresent;
+    lastPresent = now;
+    frameMs[nextFrame] = std::chrono::duration<float, std::milli>(frameTime).count();
+    nextFrame = (nextFrame + 1) % statsWindow;
+    if (frameCount < statsWindow)
+        frameCount += 1;
+
+    bool late = frameTime > interval * missedIntervals;
+    if (late)
+        missed += 1;
+    if (mode != PacingAdaptive)
+        return;
+
+    // one frame either side of the deadline must not flip vsync back and
+    // forth, so it takes several to switch either way
+    if (recentLate[recentLateIndex])
+        recentLateCount -= 1;
+    recentLate[recentLateIndex] = late;
+    if (late)
+        recentLateCount += 1;
+    recentLateIndex = (recentLateIndex + 1) % lateWindow;
+    onTimeStreak = late ? 0 : onTimeStreak + 1;
+
+    if (vsync && recentLateCount >= lateFrames)
+        setVsync(false);
+    else if (!vsync && onTimeStreak >= onTimeFrames)
+        setVsync(true);
+}
+
+FramePacer::Stats FramePacer::getStats() const
+{
+    Stats stats;
+    stats.frames = frameCount;
+    stats.missed = missed;
+    if (frameCount == 0)
+        return stats;
+
+    double total = 0.0;
+    for (int i = 0; i < frameCount; i += 1) {
+        total += frameMs[i];
+        stats.maxMs = std::max(stats.maxMs, (double)frameMs[i]);
+    }
+    stats.meanMs = total / frameCount;
+    double squares = 0.0;
+    for (int i = 0; i < frameCount; i += 1) {
+        double d = frameMs[i] - stats.meanMs;
+        squares += d * d;
+    }
+    stats.stdDevMs = sqrt(squares / frameCount);
+    return stats;
+}
+
+void FramePacer::setVsync(bool enabled)
+{
+    if (enabled == vsync)
+        return;
+    vsync = enabled;
+    window->setVerticalSyncEnabled(enabled);
+}
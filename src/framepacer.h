@@ -0,0 +1,79 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SFML/Window.hpp>
+
+#include <chrono>
+#include <vector>
+
+enum PacingMode {
+    // wait for vertical sync every frame
+    PacingVsync,
+    // present as fast as frames are drawn
+    PacingUncapped,
+    // no vsync; sleep, then spin, until the next frame is due
+    PacingCapped,
+    // vsync while frames are on time; once several are late, present
+    // without waiting so they tear instead of slipping a whole refresh,
+    // until frames have been on time for a while again
+    PacingAdaptive,
+};
+
+const char *pacingModeName(PacingMode mode);
+// Returns false if name is not a mode.
+bool parsePacingMode(const char *name, PacingMode &mode);
+
+// Decides when frames are presented and keeps statistics on how evenly
+// they came out.
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Stats {
+        int frames = 0;
+        double meanMs = 0.0;
+        double stdDevMs = 0.0;
+        double maxMs = 0.0;
+        // frames since start that took over 1.5 intervals, i.e. that were
+        // shown a refresh late
+        int missed = 0;
+    };
+
+    FramePacer();
+
+    // fps is the cap in PacingCapped and the deadline in every mode
+    void start(sf::Window &window, PacingMode mode, int fps);
+
+    // call right before and right after window.display()
+    void waitToPresent();
+    void presented();
+
+    // over the last statsWindow frames, except for missed
+    Stats getStats() const;
+    static const int statsWindow = 600;
+
+private:
+    sf::Window *window;
+    PacingMode mode;
+    Clock::duration interval;
+    bool vsync;
+
+    Clock::time_point nextPresent;
+    Clock::time_point lastPresent;
+    bool hasPresented;
+    std::vector<float> frameMs;
+    int nextFrame;
+    int frameCount;
+    int missed;
+    // adaptive: which of the last few frames were late, and how many frames
+    // in a row have not been
+    std::vector<bool> recentLate;
+    int recentLateIndex;
+    int recentLateCount;
+    int onTimeStreak;
+
+    void setVsync(bool enabled);
+};
+
+#endif // FRAMEPACER_H
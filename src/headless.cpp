@@ -0,0 +1,112 @@
+#include "headless.h"
+#include "resourcebundle.h"
+#include "rollback.h"
+#include "world.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// how long to keep answering a peer that is still missing our last input
+static int lingerMs = 2000;
+
+static void runOnline(World &world, ResourceBundle &bundle, const NetConfig &net, InputSource *input, int steps,
+                      ChecksumLog *checksums)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    RollbackSession session(&world, &bundle, net);
+    session.checksums = checksums;
+    session.connect();
+
+    const std::vector<int> &localPlayers = session.getLocalPlayers();
+    std::vector<PlayerInput> localInput(localPlayers.size());
+    Clock::duration timeStep = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<float>(world.timeStep));
+    Clock::time_point nextStep = Clock::now();
+    while (session.getLocalStep() < steps) {
+        int step = session.getLocalStep();
+        for (int i = 0; i < (int)localPlayers.size(); i += 1) {
+            input->getInput(step, localPlayers[i], localInput[i]);
+        }
+        if (session.advance(localInput)) {
+            nextStep += std::chrono::duration_cast<Clock::duration>(timeStep * session.getStepScale());
+            std::this_thread::sleep_until(nextStep);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            nextStep = Clock::now();
+        }
+    }
+
+    // both sides must end on the same state, and the peer needs all of our
+    // input to get there
+    Clock::time_point giveUp = Clock::now() + std::chrono::milliseconds(lingerMs);
+    while ((session.getConfirmedStep() < steps || session.getPeerAckedStep() < steps) &&
+           Clock::now() < giveUp)
+    {
+        session.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (session.getConfirmedStep() < steps)
+        std::cerr << "peer stopped sending before step " << steps << "\n";
+
+    std::cout << "final state " << std::hex << std::setw(16) << std::setfill('0') << world.checksum() <<
+                 std::dec << std::setfill(' ') << "\n";
+    std::cout << session.rollbacks << " rollbacks, " << session.resimulatedSteps << " steps resimulated, " <<
+                 session.stalls << " stalls\n";
+}
+
+Headless::Headless() :
+    mapKey("map/basic.map"),
+    steps(60 * 60),
+    input(NULL),
+    playback(NULL),
+    seekStep(0),
+    recording(NULL),
+    net(NULL),
+    checksums(NULL)
+{
+}
+
+int Headless::start()
+{
+    ResourceBundle bundle;
+    bundle.open("assets.bundle");
+
+    World world(&bundle);
+    world.loadMap(mapKey);
+
+    if (playback) {
+        playback->seek(&world, seekStep);
+        steps = 0;
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (playback) {
+        while (playback->playStep(&world)) {
+            world.step();
+            if (checksums)
+                checksums->record(world);
+            steps += 1;
+        }
+    } else if (net) {
+        runOnline(world, bundle, *net, input, steps, checksums);
+    } else {
+        for (int step = 0; step < steps; step += 1) {
+            for (int i = 0; i < (int)world.players.size(); i += 1) {
+                input->getInput(step, i, world.playerState.input[i]);
+            }
+            if (recording)
+                recording->recordStep(&world);
+            world.step();
+            if (checksums)
+                checksums->record(world);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    std::cout << steps << " steps in " << elapsed.count() << "s (" <<
+                 (steps / elapsed.count()) << " steps/s)\n";
+    return 0;
+}
@@ -0,0 +1,34 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <string>
+
+#include "checksumlog.h"
+#include "inputsource.h"
+#include "netlink.h"
+#include "replay.h"
+
+// Steps the simulation as fast as possible with no window and no drawing.
+class Headless
+{
+public:
+    Headless();
+
+    std::string mapKey;
+    int steps;
+    InputSource *input;
+    // when set, input comes from this replay instead and runs to its end
+    Replay *playback;
+    int seekStep;
+    Replay *recording;
+    // when set, plays online against a peer at real time; input only
+    // drives this side's players
+    const NetConfig *net;
+    // when set, gets the world's checksums after every step; online, after
+    // every step with real input from both sides
+    ChecksumLog *checksums;
+
+    int start();
+};
+
+#endif // HEADLESS_H
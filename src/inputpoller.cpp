@@ -0,0 +1,199 @@
+#include "inputpoller.h"
+
+#include <SFML/Window.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+static float deadZoneThreshold = 0.15f;
+// a joystick is sampled this often; well under a step at 60 Hz
+static int pollIntervalUs = 1000;
+// samples kept per player, a quarter second at the poll rate
+static int ringSize = 256;
+// the keyboard drives this player, alongside its joystick if it has one
+static int keyboardPlayer = 0;
+
+#ifdef __linux__
+static const bool pollOnOwnThread = true;
+#else
+static const bool pollOnOwnThread = false;
+#endif
+
+static bool PlayerInput::*const buttons[] = {
+    &PlayerInput::btnJump,
+    &PlayerInput::btnFireGrapple,
+    &PlayerInput::btnUnhookGrapple,
+    &PlayerInput::btnReelOut,
+};
+static const int buttonCount = sizeof(buttons) / sizeof(buttons[0]);
+
+static float joyAxis(int index, sf::Joystick::Axis axis) {
+    float val = sf::Joystick::getAxisPosition(index, axis) / 100.0f;
+    return (fabsf(val) < deadZoneThreshold) ? 0.0f : val;
+}
+
+static float keyAxis(sf::Keyboard::Key negative, sf::Keyboard::Key positive) {
+    return (sf::Keyboard::isKeyPressed(positive) ? 1.0f : 0.0f) -
+           (sf::Keyboard::isKeyPressed(negative) ? 1.0f : 0.0f);
+}
+
+InputPoller::InputPoller() :
+    running(false),
+    keyboardEnabled(true),
+    deviceMutex(NULL),
+    playerCount(0),
+    newest(0),
+    sampleCount(0),
+    sampleSerial(0),
+    latchedSerial(0)
+{
+}
+
+InputPoller::~InputPoller()
+{
+    stop();
+}
+
+void InputPoller::start(int playerCount, std::mutex *deviceMutex)
+{
+    this->playerCount = playerCount;
+    this->deviceMutex = deviceMutex;
+    sampleTimes.resize(ringSize);
+    samples.resize(ringSize * playerCount);
+    latched.resize(playerCount);
+    windowSample.resize(playerCount);
+    newest = 0;
+    sampleCount = 0;
+    sampleSerial = 0;
+    latchedSerial = 0;
+
+    running = true;
+    if (pollOnOwnThread)
+        thread = std::thread(&InputPoller::run, this);
+}
+
+void InputPoller::stop()
+{
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+void InputPoller::setKeyboardEnabled(bool enabled)
+{
+    keyboardEnabled = enabled;
+}
+
+void InputPoller::sampleOnWindowThread()
+{
+    if (pollOnOwnThread || !running)
+        return;
+    sample(windowSample);
+    addSample(windowSample);
+}
+
+void InputPoller::run()
+{
+    std::vector<PlayerInput> input(playerCount);
+    Clock::time_point nextPoll = Clock::now();
+    while (running) {
+        sample(input);
+        addSample(input);
+
+        Clock::time_point now = Clock::now();
+        nextPoll += std::chrono::microseconds(pollIntervalUs);
+        if (nextPoll < now)
+            nextPoll = now;
+        std::this_thread::sleep_until(nextPoll);
+    }
+}
+
+void InputPoller::addSample(const std::vector<PlayerInput> &input)
+{
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    newest = (newest + 1) % ringSize;
+    sampleCount = std::min(sampleCount + 1, ringSize);
+    sampleSerial += 1;
+    sampleTimes[newest] = now;
+    std::copy(input.begin(), input.end(), samples.begin() + newest * playerCount);
+}
+
+void InputPoller::sample(std::vector<PlayerInput> &input)
+{
+    std::lock_guard<std::mutex> lock(*deviceMutex);
+    sf::Joystick::update();
+    for (int i = 0; i < playerCount; i += 1) {
+        input[i].reset();
+        if (i < sf::Joystick::Count && sf::Joystick::isConnected(i)) {
+            input[i].xAxis = joyAxis(i, sf::Joystick::X);
+            input[i].yAxis = joyAxis(i, sf::Joystick::Y);
+            input[i].btnJump = sf::Joystick::isButtonPressed(i, 0);
+            input[i].btnFireGrapple = sf::Joystick::isButtonPressed(i, 2);
+            input[i].btnUnhookGrapple = sf::Joystick::isButtonPressed(i, 1);
+            input[i].btnReelOut = sf::Joystick::isButtonPressed(i, 3);
+        }
+    }
+
+    if (!keyboardEnabled || keyboardPlayer >= playerCount)
+        return;
+    // WASD moves and aims; keys only override a stick that is at rest
+    PlayerInput &keys = input[keyboardPlayer];
+    float xAxis = keyAxis(sf::Keyboard::A, sf::Keyboard::D);
+    float yAxis = keyAxis(sf::Keyboard::W, sf::Keyboard::S);
+    if (xAxis != 0.0f || yAxis != 0.0f) {
+        keys.xAxis = xAxis;
+        keys.yAxis = yAxis;
+    }
+    keys.btnJump = keys.btnJump || sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+    keys.btnFireGrapple = keys.btnFireGrapple || sf::Keyboard::isKeyPressed(sf::Keyboard::J);
+    keys.btnUnhookGrapple = keys.btnUnhookGrapple || sf::Keyboard::isKeyPressed(sf::Keyboard::K);
+    keys.btnReelOut = keys.btnReelOut || sf::Keyboard::isKeyPressed(sf::Keyboard::L);
+}
+
+void InputPoller::latch(std::vector<PlayerInput> &input)
+{
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    input.resize(playerCount);
+    if (sampleCount == 0) {
+        for (int i = 0; i < playerCount; i += 1) {
+            input[i].reset();
+        }
+        return;
+    }
+
+    // a press and release between two steps still has to reach the game
+    int unseen = (int)std::min<long long>(sampleSerial - latchedSerial, sampleCount);
+    latchedSerial = sampleSerial;
+    for (int i = 0; i < playerCount; i += 1) {
+        input[i] = sampleAt(newest, i);
+        PlayerInput previous = latched[i];
+        for (int k = unseen - 1; k >= 0; k -= 1) {
+            int slot = (newest - k + ringSize) % ringSize;
+            const PlayerInput &current = sampleAt(slot, i);
+            for (int j = 0; j < buttonCount; j += 1) {
+                if (!(current.*buttons[j]) || previous.*buttons[j])
+                    continue;
+                input[i].*buttons[j] = true;
+                double ms = std::chrono::duration<double, std::milli>(now - sampleTimes[slot]).count();
+                latency.presses += 1;
+                latency.totalMs += ms;
+                latency.maxMs = std::max(latency.maxMs, ms);
+            }
+            previous = current;
+        }
+        latched[i] = sampleAt(newest, i);
+    }
+}
+
+InputPoller::LatencyStats InputPoller::getLatency()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return latency;
+}
+
+PlayerInput &InputPoller::sampleAt(int slot, int player)
+{
+    return samples[slot * playerCount + player];
+}
@@ -0,0 +1,80 @@
+#ifndef INPUTPOLLER_H
+#define INPUTPOLLER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "world.h"
+
+// Samples joysticks and the keyboard on its own thread, far more often than
+// frames are drawn, so the simulation can latch the newest input right
+// before each step instead of whatever the render thread saw last frame.
+//
+// SFML only supports reading input off the window's thread on Linux.
+// Elsewhere there is no polling thread, and the window thread samples once
+// a frame through sampleOnWindowThread().
+class InputPoller
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // how long presses waited between being sampled and being latched
+    struct LatencyStats {
+        int presses = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    InputPoller();
+    ~InputPoller();
+
+    // deviceMutex must also be held around window.pollEvent, which updates
+    // the joystick state this thread reads
+    void start(int playerCount, std::mutex *deviceMutex);
+    void stop();
+
+    // keyboard input only counts while the window has focus
+    void setKeyboardEnabled(bool enabled);
+    // call once a frame; does nothing where the poller has its own thread
+    void sampleOnWindowThread();
+
+    // Copies the newest sample for each player, with any button that went
+    // down since the last latch held down, even if it is already back up,
+    // and notes how long each such press waited.
+    void latch(std::vector<PlayerInput> &input);
+
+    LatencyStats getLatency();
+
+private:
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> keyboardEnabled;
+    std::mutex *deviceMutex;
+
+    std::mutex mutex;
+    int playerCount;
+    // a ring of samples, each with a time and then input for every player;
+    // the oldest is overwritten first
+    std::vector<Clock::time_point> sampleTimes;
+    std::vector<PlayerInput> samples;
+    int newest;
+    int sampleCount;
+    // samples taken in total, and how many of those had been when we last
+    // latched
+    long long sampleSerial;
+    long long latchedSerial;
+    // the newest sample as of the last latch
+    std::vector<PlayerInput> latched;
+    LatencyStats latency;
+    std::vector<PlayerInput> windowSample;
+
+    void run();
+    void sample(std::vector<PlayerInput> &input);
+    void addSample(const std::vector<PlayerInput> &input);
+    PlayerInput &sampleAt(int slot, int player);
+};
+
+#endif // INPUTPOLLER_H
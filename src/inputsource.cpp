@@ -0,0 +1,126 @@
+#include "inputsource.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+ScriptInputSource::ScriptInputSource() :
+    cursor(0)
+{
+}
+
+void ScriptInputSource::load(const std::string &path)
+{
+    std::ifstream in(path.c_str());
+    if (!in) {
+        std::cerr << "Unable to open input script: " << path << "\n";
+        std::exit(1);
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber += 1;
+        size_t commentStart = line.find('#');
+        if (commentStart != std::string::npos)
+            line.erase(commentStart);
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        std::istringstream ss(line);
+        Event event;
+        std::string buttons;
+        if (!(ss >> event.step >> event.player >> event.input.xAxis >> event.input.yAxis >> buttons)) {
+            std::cerr << path << ":" << lineNumber << ": expected <step> <player> <xAxis> <yAxis> <buttons>\n";
+            std::exit(1);
+        }
+        if (!events.empty() && event.step < events.back().step) {
+            std::cerr << path << ":" << lineNumber << ": events must be sorted by step\n";
+            std::exit(1);
+        }
+        for (int i = 0; i < (int)buttons.size(); i += 1) {
+            switch (buttons[i]) {
+            case 'j':
+                event.input.btnJump = true;
+                break;
+            case 'f':
+                event.input.btnFireGrapple = true;
+                break;
+            case 'u':
+                event.input.btnUnhookGrapple = true;
+                break;
+            case 'r':
+                event.input.btnReelOut = true;
+                break;
+            case '-':
+                break;
+            default:
+                std::cerr << path << ":" << lineNumber << ": unrecognized button: " << buttons[i] << "\n";
+                std::exit(1);
+            }
+        }
+        events.push_back(event);
+    }
+}
+
+void ScriptInputSource::getInput(int step, int playerIndex, PlayerInput &input)
+{
+    // steps only move forward, so apply every event up to this one
+    while (cursor < (int)events.size() && events[cursor].step <= step) {
+        const Event &event = events[cursor];
+        if (event.player >= (int)current.size())
+            current.resize(event.player + 1);
+        current[event.player] = event.input;
+        cursor += 1;
+    }
+
+    if (playerIndex < (int)current.size())
+        input = current[playerIndex];
+    else
+        input.reset();
+}
+
+RandomInputSource::RandomInputSource(unsigned int seed) :
+    seed(seed)
+{
+}
+
+unsigned int RandomInputSource::next(Hold &hold)
+{
+    // xorshift32; std::rand is not the same across platforms
+    hold.state ^= hold.state << 13;
+    hold.state ^= hold.state >> 17;
+    hold.state ^= hold.state << 5;
+    return hold.state;
+}
+
+float RandomInputSource::nextFloat(Hold &hold)
+{
+    return (next(hold) % 20001) / 10000.0f - 1.0f;
+}
+
+void RandomInputSource::getInput(int step, int playerIndex, PlayerInput &input)
+{
+    while (playerIndex >= (int)holds.size()) {
+        // a stream of its own for each player
+        Hold hold;
+        hold.state = seed ^ ((unsigned int)(holds.size() + 1) * 0x9e3779b9u);
+        if (hold.state == 0)
+            hold.state = 1;
+        hold.untilStep = -1;
+        holds.push_back(hold);
+    }
+
+    Hold &hold = holds[playerIndex];
+    if (step > hold.untilStep) {
+        hold.untilStep = step + 5 + next(hold) % 55;
+        hold.input.xAxis = nextFloat(hold);
+        hold.input.yAxis = nextFloat(hold);
+        hold.input.btnJump = next(hold) % 3 == 0;
+        hold.input.btnFireGrapple = next(hold) % 3 == 0;
+        hold.input.btnUnhookGrapple = next(hold) % 6 == 0;
+        hold.input.btnReelOut = next(hold) % 6 == 0;
+    }
+    input = hold.input;
+}
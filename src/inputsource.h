@@ -0,0 +1,68 @@
+#ifndef INPUTSOURCE_H
+#define INPUTSOURCE_H
+
+#include <string>
+#include <vector>
+
+#include "world.h"
+
+// Supplies player input to the simulation when there is no joystick,
+// e.g. in headless runs.
+class InputSource
+{
+public:
+    virtual ~InputSource() {}
+    virtual void getInput(int step, int playerIndex, PlayerInput &input) = 0;
+};
+
+// Reads an input script. One event per line:
+//
+//     <step> <player> <xAxis> <yAxis> <buttons>
+//
+// buttons is any combination of j (jump), f (fire grapple), u (unhook) and
+// r (reel out), or - for none. An event holds until the next event for the
+// same player. Lines must be sorted by step; # starts a comment.
+class ScriptInputSource : public InputSource
+{
+public:
+    ScriptInputSource();
+    void load(const std::string &path);
+    virtual void getInput(int step, int playerIndex, PlayerInput &input);
+
+private:
+    struct Event {
+        int step;
+        int player;
+        PlayerInput input;
+    };
+
+    std::vector<Event> events;
+    int cursor;
+    std::vector<PlayerInput> current;
+};
+
+// Generates random input from a seed. The same seed always produces the
+// same sequence, and each player's input depends only on the seed and the
+// player, so an online side that only asks for its own players gets what an
+// offline run would.
+class RandomInputSource : public InputSource
+{
+public:
+    RandomInputSource(unsigned int seed);
+    virtual void getInput(int step, int playerIndex, PlayerInput &input);
+
+private:
+    struct Hold {
+        unsigned int state;
+        int untilStep;
+        PlayerInput input;
+    };
+
+    unsigned int seed;
+    std::vector<Hold> holds;
+
+    static unsigned int next(Hold &hold);
+    static float nextFloat(Hold &hold);
+};
+
+#endif // INPUTSOURCE_H
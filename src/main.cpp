@@ -1,6 +1,207 @@
 #include "mainwindow.h"
+#include "batchrunner.h"
+#include "checksumlog.h"
+#include "headless.h"
+#include "profiler.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+static int usage(const char *arg0) {
+    std::cerr << "Usage: " << arg0 << " [options]\n"
+                 "\n"
+                 "Options:\n"
+                 "  --headless         step the simulation without a window\n"
+                 "  --batch <n>        simulate n matches headless across all cores\n"
+                 "  --map <key>        map resource to load (default map/basic.map)\n"
+                 "  --steps <n>        headless: number of steps to run (default 3600)\n"
+                 "  --script <path>    headless: read player input from a script\n"
+                 "  --seed <n>         headless: generate random player input (default 1)\n"
+                 "  --threads <n>      batch: worker threads (default one per core)\n"
+                 "  --tune <name=val>  batch: override a tuning constant, e.g. jumpForce=900\n"
+                 "  --results <path>   batch: write one CSV row per match\n"
+                 "  --record <path>    save the session's input as a replay\n"
+                 "  --replay <path>    play back a replay instead of reading input\n"
+                 "  --seek <step>      start replay playback at this step\n"
+                 "  --net-side <0|1>   play online as this side, driving every other player\n"
+                 "  --net-port <n>     online: local UDP port (default 7000)\n"
+                 "  --net-peer <h:p>   online: the other side (default 127.0.0.1:7001)\n"
+                 "  --net-latency <ms> online: delay every packet we send\n"
+                 "  --net-jitter <ms>  online: add up to this much more delay\n"
+                 "  --net-loss <f>     online: drop this fraction of packets we send\n"
+                 "  --pacing <mode>    vsync (default), uncapped, cap or adaptive\n"
+                 "  --fps <n>          frame rate to cap at and to count late frames by (default 60)\n"
+                 "  --checksums <path> headless: write world checksums after every step\n"
+                 "  --diverge <a> <b>  find the first step where two checksum files differ\n"
+                 "  --trace <path>     write a chrome://tracing profile on exit\n";
+    return 1;
+}
 
 int main(int argc, char * argv[]) {
-    MainWindow *window = new MainWindow();
-    return window->start();
+    bool headless = false;
+    std::string mapKey = "map/basic.map";
+    int steps = 60 * 60;
+    const char *scriptPath = NULL;
+    unsigned int seed = 1;
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    int seekStep = 0;
+    const char *tracePath = NULL;
+    const char *checksumsPath = NULL;
+    PacingMode pacing = PacingVsync;
+    int fps = 60;
+    int batchMatches = 0;
+    int threads = 0;
+    Tuning tuning;
+    const char *resultsPath = NULL;
+    NetConfig net;
+    bool online = false;
+
+    for (int i = 1; i < argc; i += 1) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--headless") == 0) {
+            headless = true;
+        } else if (i + 1 < argc && strcmp(arg, "--batch") == 0) {
+            batchMatches = atoi(argv[++i]);
+            if (batchMatches <= 0)
+                return usage(argv[0]);
+        } else if (i + 1 < argc && strcmp(arg, "--threads") == 0) {
+            threads = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--tune") == 0) {
+            std::string tune = argv[++i];
+            size_t eq = tune.find('=');
+            if (eq == std::string::npos || !tuning.set(tune.substr(0, eq), atof(tune.c_str() + eq + 1))) {
+                std::cerr << "unknown tuning value: " << tune << "\n";
+                return 1;
+            }
+        } else if (i + 1 < argc && strcmp(arg, "--results") == 0) {
+            resultsPath = argv[++i];
+        } else if (i + 1 < argc && strcmp(arg, "--map") == 0) {
+            mapKey = argv[++i];
+        } else if (i + 1 < argc && strcmp(arg, "--steps") == 0) {
+            steps = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--script") == 0) {
+            scriptPath = argv[++i];
+        } else if (i + 1 < argc && strcmp(arg, "--seed") == 0) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(arg, "--record") == 0) {
+            recordPath = argv[++i];
+        } else if (i + 1 < argc && strcmp(arg, "--replay") == 0) {
+            replayPath = argv[++i];
+        } else if (i + 1 < argc && strcmp(arg, "--seek") == 0) {
+            seekStep = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--net-side") == 0) {
+            online = true;
+            net.side = atoi(argv[++i]);
+            if (net.side != 0 && net.side != 1)
+                return usage(argv[0]);
+        } else if (i + 1 < argc && strcmp(arg, "--net-port") == 0) {
+            net.port = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--net-peer") == 0) {
+            std::string peer = argv[++i];
+            size_t colon = peer.rfind(':');
+            if (colon == std::string::npos)
+                return usage(argv[0]);
+            net.peerHost = peer.substr(0, colon);
+            net.peerPort = atoi(peer.c_str() + colon + 1);
+        } else if (i + 1 < argc && strcmp(arg, "--net-latency") == 0) {
+            net.latencyMs = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--net-jitter") == 0) {
+            net.jitterMs = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--net-loss") == 0) {
+            net.loss = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(arg, "--pacing") == 0) {
+            if (!parsePacingMode(argv[++i], pacing))
+                return usage(argv[0]);
+        } else if (i + 1 < argc && strcmp(arg, "--fps") == 0) {
+            fps = atoi(argv[++i]);
+            if (fps <= 0)
+                return usage(argv[0]);
+        } else if (i + 1 < argc && strcmp(arg, "--checksums") == 0) {
+            checksumsPath = argv[++i];
+        } else if (i + 2 < argc && strcmp(arg, "--diverge") == 0) {
+            return findDivergence(argv[i + 1], argv[i + 2]);
+        } else if (i + 1 < argc && strcmp(arg, "--trace") == 0) {
+            tracePath = argv[++i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    if (online && (replayPath || recordPath || batchMatches > 0)) {
+        std::cerr << "online play cannot be recorded, replayed or batched\n";
+        return 1;
+    }
+    if (checksumsPath && (!headless || batchMatches > 0)) {
+        std::cerr << "--checksums only works with --headless runs\n";
+        return 1;
+    }
+    // each side drops different packets
+    net.shimSeed = seed + net.side;
+
+    Replay playback;
+    Replay recording;
+    if (replayPath) {
+        playback.load(replayPath);
+        mapKey = playback.mapKey;
+    }
+
+    if (tracePath) {
+        Profiler::startTrace();
+        Profiler::setEnabled(true);
+    }
+
+    int ret;
+    if (batchMatches > 0) {
+        BatchRunner runner;
+        runner.mapKey = mapKey;
+        runner.matches = batchMatches;
+        runner.steps = steps;
+        runner.threads = threads;
+        runner.seed = seed;
+        runner.tuning = tuning;
+        if (resultsPath)
+            runner.resultsPath = resultsPath;
+        ret = runner.start();
+    } else if (headless) {
+        ScriptInputSource scriptInput;
+        RandomInputSource randomInput(seed);
+
+        Headless runner;
+        runner.mapKey = mapKey;
+        runner.steps = steps;
+        if (scriptPath) {
+            scriptInput.load(scriptPath);
+            runner.input = &scriptInput;
+        } else {
+            runner.input = &randomInput;
+        }
+        runner.playback = replayPath ? &playback : NULL;
+        runner.seekStep = seekStep;
+        runner.recording = recordPath ? &recording : NULL;
+        runner.net = online ? &net : NULL;
+        ChecksumLog checksums;
+        if (checksumsPath) {
+            checksums.open(checksumsPath);
+            runner.checksums = &checksums;
+        }
+        ret = runner.start();
+    } else {
+        MainWindow *window = new MainWindow();
+        window->mapKey = mapKey;
+        window->playback = replayPath ? &playback : NULL;
+        window->seekStep = seekStep;
+        window->recording = recordPath ? &recording : NULL;
+        window->net = online ? &net : NULL;
+        window->pacing = pacing;
+        window->fps = fps;
+        ret = window->start();
+    }
+
+    if (recordPath)
+        recording.save(recordPath);
+    if (tracePath)
+        Profiler::writeTrace(tracePath);
+    return ret;
 }
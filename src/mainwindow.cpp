@@ -1,160 +1,80 @@
 #include "mainwindow.h"
+#include "profiler.h"
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <cmath>
 #include <algorithm>
-#include <cassert>
+#include <thread>
 
 static int windowWidth = 1920;
 static int windowHeight = 1080;
 
-static float deadZoneThreshold = 0.15f;
-static float maxPlayerSpeed = 200.0f;
-static float playerMoveForceAir = 300.0f;
-static float playerMoveForceGround = 600.0f;
-static float jumpForce = 800.0f;
-static int maxJumpFrames = 14;
-static float clawShootSpeed = 2500.0f;
-static float minClawDist = 50.0f;
-static float retractClawDist = 150.0f;
-static float clawReelInSpeedAttached = 12.0f;
-static float clawReelInSpeedDetached = 20.0f;
-static float jnAccMin = -3000.0f;
-static float maxReelOutLength = 99999999.0f;
+static float animFrameTime = 0.1f;
+// most steps the simulation runs at once before it drops time
+static int maxStepsPerFrame = 5;
+// how far the arrow keys move during replay playback
+static int replaySeekSteps = 5 * 60;
+// spritesheet, font and world
+static int loadingJobCount = 3;
+static float loadingBarWidth = 480.0f;
+static float loadingBarHeight = 24.0f;
 
 
 static float toDegrees(float radians) {
     return radians * 180.0f / M_PI;
 }
 
-static float joyAxis(int index, sf::Joystick::Axis axis) {
-    float val = sf::Joystick::getAxisPosition(index, axis) / 100.0f;
-    return (fabsf(val) < deadZoneThreshold) ? 0.0f : val;
-}
-
-static float sign(float x) {
-    if (x < 0) {
-        return -1.0f;
-    } else if (x > 0) {
-        return 1.0f;
-    } else {
-        return 0.0f;
-    }
-}
-
-MainWindow::MainWindow()
+MainWindow::MainWindow() :
+    mapKey("map/basic.map"),
+    playback(NULL),
+    seekStep(0),
+    recording(NULL),
+    net(NULL),
+    pacing(PacingVsync),
+    fps(60),
+    simRunning(false),
+    seekRequest(0),
+    quickSaveRequest(false),
+    quickLoadRequest(false),
+    showProfiler(false),
+    profilerStatsVersion(-1)
 {
 }
 
-MainWindow::Player::Player(int i, MainWindow *window)
-{
-    index = i;
-    sprite.setFrameTime(sf::seconds(0.1f));
-
-    clawFixtureUserData.window = window;
-    clawFixtureUserData.type = ClawFixture;
-    clawFixtureUserData.player = this;
-    clawFixtureUserData.canGrapple = true;
-
-    aimUnit = {1, 0};
-
-    resetButtons();
-}
-
-void MainWindow::Player::resetButtons()
-{
-    xAxis = 0.0f;
-    yAxis = 0.0f;
-    btnJump = false;
-    btnFireGrapple = false;
-    btnUnhookGrapple = false;
-    btnReelOut = false;
-}
-
-void MainWindow::groundQueryCallback(cpShape *shape, void *data) {
-    Player *player = reinterpret_cast<Player *>(data);
-    player->footContacts += 1;
-}
-
-void MainWindow::postSolveCollisionCallback(cpArbiter *arb, cpSpace *space, void *data)
-{
-    MainWindow *window = reinterpret_cast<MainWindow *>(data);
-    window->onPostSolveCollision(arb);
-}
-
 int MainWindow::start()
 {
-    int err = rucksack_bundle_open("assets.bundle", &bundle);
-    if (err != RuckSackErrorNone) {
-        std::cerr << "Error opening rucksack bundle: " << rucksack_err_str(err) << "\n";
-        std::exit(1);
-    }
-
+    // open the window first so there is something on screen while loading
+    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight), "Grapple", sf::Style::Default);
+    window.setVerticalSyncEnabled(true);
 
+    bundle.open("assets.bundle");
+    loadAssets(window);
 
-    RuckSackFileEntry *entry = rucksack_bundle_find_file(bundle, "spritesheet", -1);
-    if (!entry) {
-        std::cerr << "Could not find resource 'spritesheet' in bundle.\n";
-        std::exit(1);
-    }
-    RuckSackTexture *rsTexture;
-    err = rucksack_file_open_texture(entry, &rsTexture);
-    if (err) {
-        std::cerr << "Error reading 'spritesheet' as texture: " << rucksack_err_str(err) << "\n";
-        std::exit(1);
-    }
-    std::vector<unsigned char> buffer;
-    buffer.resize(rucksack_texture_size(rsTexture));
-    rucksack_texture_read(rsTexture, &buffer[0]);
-    spritesheet.loadFromMemory(&buffer[0], buffer.size());
-
-    RuckSackFileEntry *fontEntry = rucksack_bundle_find_file(bundle, "font/LuckiestGuy.ttf", -1);
-    if (!fontEntry) {
-        std::cerr << "Could not find resource 'font/LuckiestGuy.ttf' in bundle.\n";
-        std::exit(1);
-    }
-    buffer.resize(rucksack_file_size(fontEntry));
-    rucksack_file_read(fontEntry, &buffer[0]);
-    font.loadFromMemory(&buffer[0], buffer.size());
-
-    long imageCount = rucksack_texture_image_count(rsTexture);
-    RuckSackImage **images = (RuckSackImage **)malloc(sizeof(RuckSackImage *) * imageCount);
-    rucksack_texture_get_images(rsTexture, images);
-    for (int i = 0; i < imageCount; i += 1) {
-        struct RuckSackImage *image = images[i];
-        imageMap[std::string(image->key, image->key_size)] = image;
-    }
-
-    std::vector<std::string> animFrames;
+    std::vector<ImageId> animFrames;
 
     animFrames.clear();
-    animFrames.push_back("img/walk-0.png");
-    animFrames.push_back("img/walk-1.png");
-    animFrames.push_back("img/walk-2.png");
-    animFrames.push_back("img/walk-3.png");
-    animFrames.push_back("img/walk-4.png");
-    animFrames.push_back("img/walk-5.png");
+    animFrames.push_back(ImgWalk0);
+    animFrames.push_back(ImgWalk1);
+    animFrames.push_back(ImgWalk2);
+    animFrames.push_back(ImgWalk3);
+    animFrames.push_back(ImgWalk4);
+    animFrames.push_back(ImgWalk5);
     loadAnimation(walkingAnim, animFrames);
 
     animFrames.clear();
-    animFrames.push_back("img/jump-0.png");
-    animFrames.push_back("img/jump-1.png");
-    animFrames.push_back("img/jump-2.png");
-    animFrames.push_back("img/jump-3.png");
+    animFrames.push_back(ImgJump0);
+    animFrames.push_back(ImgJump1);
+    animFrames.push_back(ImgJump2);
+    animFrames.push_back(ImgJump3);
     loadAnimation(jumpingAnim, animFrames);
 
     animFrames.clear();
-    animFrames.push_back("img/man.png");
+    animFrames.push_back(ImgMan);
     loadAnimation(stillAnim, animFrames);
 
-    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight), "Grapple", sf::Style::Default);
-    window.setVerticalSyncEnabled(true);
-    float timeStep = 1.0f/60.0f;
-
-    arenaWidth = windowWidth;
-    arenaHeight = windowHeight;
-    armLength = 50.0f;
     ropeColor = sf::Color(255, 255, 0);
+    ropeThickness = 2.0f;
 
 
     physDebugText.setFont(font);
@@ -163,527 +83,524 @@ int MainWindow::start()
     physDebugText.setColor(sf::Color(0, 0, 0, 255));
     physDebugText.setPosition(0, 0);
 
-    space = cpSpaceNew();
-    cpSpaceSetGravity(space, cpv(0, 1000));
-    cpSpaceSetDamping(space, 0.95f);
-    cpSpaceAddCollisionHandler(space, 0, 0, NULL, NULL, postSolveCollisionCallback, NULL, this);
+    profilerText.setFont(font);
+    profilerText.setCharacterSize(16);
+    profilerText.setColor(sf::Color(0, 0, 0, 255));
+    profilerText.setPosition(0, 30);
 
-    players.push_back(new Player(0, this));
-    players.push_back(new Player(1, this));
-    players.push_back(new Player(2, this));
-    players.push_back(new Player(3, this));
+    initSprites();
+    camera.setViewportSize(windowWidth, windowHeight);
+    mapLayout.capture(*world);
+    buildStaticLayer();
 
-    loadMap();
+    if (!playback)
+        inputPoller.start(world->players.size(), &deviceMutex);
+    snapshots.back().capture(*world, std::chrono::steady_clock::now());
+    snapshots.publish();
 
+    // From here on the simulation thread owns the world. This thread only
+    // sees it through snapshots.
+    simRunning = true;
+    std::thread simThread(&MainWindow::runSimulation, this);
 
+    // the loading screen always waits for vsync
+    pacer.start(window, pacing, fps);
     sf::Clock frameClock;
     while (window.isOpen())
     {
-        sf::Event event;
-        while (window.pollEvent(event))
-        {
-            switch (event.type) {
-            case sf::Event::Closed:
-                window.close();
-                break;
-            case sf::Event::KeyPressed:
-                switch (event.key.code) {
-                case sf::Keyboard::Escape:
-                    window.close();
-                    break;
-                default:
-                    break;
-                }
-                break;
-            default:
-                break;
-            }
-        }
+        Profiler::endFrame();
+        Profiler::Zone frameZone("frame");
 
-        sf::Time frameTime = frameClock.restart();
+        pollEvents(window);
+        inputPoller.sampleOnWindowThread();
 
-        for (int i = 0; i < (int)players.size(); i += 1) {
-            Player *player = players[i];
-            if (player->queuePivotJoint) {
-                player->queuePivotJoint = false;
-                cpSpaceAddConstraint(space, &player->pivotJoint->constraint);
-                setPlayerClawState(player, ClawStateAttached);
-                float clawDist = cpvlength(cpvsub(cpBodyGetPos(player->clawBody), cpBodyGetPos(player->body)));
-                float newMax = std::max(clawDist, minClawDist);
-                cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
-            }
-        }
+        sf::Time frameTime = frameClock.restart();
 
+        snapshots.update();
+        const RenderSnapshot &snapshot = snapshots.front();
+        camera.update(snapshot, frameTime.asSeconds());
 
+        window.clear(sf::Color(158, 204, 233, 255));
+        window.setView(camera.getView());
+        updateSprites(snapshot);
+        draw(window, snapshot, frameTime);
+        drawText(window);
+        {
+            Profiler::Zone zone("pace");
+            pacer.waitToPresent();
+        }
+        {
+            Profiler::Zone zone("display");
+            window.display();
+        }
+        pacer.presented();
+    }
 
-        cpSpaceStep(space, timeStep);
+    simRunning = false;
+    simThread.join();
+    inputPoller.stop();
 
-        window.clear(sf::Color(158, 204, 233, 255));
+    FramePacer::Stats frameStats = pacer.getStats();
+    std::cout << std::fixed << std::setprecision(2) << "frames (" << pacingModeName(pacing) <<
+                 ", last " << frameStats.frames << "): mean " << frameStats.meanMs << " ms, std dev " <<
+                 frameStats.stdDevMs << " ms, max " << frameStats.maxMs << " ms; " << frameStats.missed <<
+                 " late in total\n";
+    return 0;
+}
 
-        for (int i = 0; i < (int)players.size(); i += 1) {
-            Player *player = players[i];
-            cpVect pos = player->body->p;
-            player->sprite.setPosition(pos.x, pos.y);
-            player->sprite.setRotation(toDegrees(cpBodyGetAngle(player->body)));
-            player->resetButtons();
-            if (sf::Joystick::isConnected(i)) {
-                player->xAxis = joyAxis(i, sf::Joystick::X);
-                player->yAxis = joyAxis(i, sf::Joystick::Y);
-                player->btnJump = sf::Joystick::isButtonPressed(i, 0);
-                player->btnFireGrapple = sf::Joystick::isButtonPressed(i, 2);
-                player->btnUnhookGrapple = sf::Joystick::isButtonPressed(i, 1);
-                player->btnReelOut = sf::Joystick::isButtonPressed(i, 3);
-            }
+// Decoding the spritesheet, reading the font and building the world do not
+// depend on each other, so each gets its own thread while this one keeps
+// the window drawn. Only the texture upload has to happen here, where the
+// GL context is.
+void MainWindow::loadAssets(sf::RenderWindow &window)
+{
+    std::atomic<int> finished(0);
+    sf::Image spritesheetImage;
+
+    std::thread spritesheetThread([&]() {
+        // the encoded image is freed as soon as it is decoded
+        std::vector<unsigned char> buffer;
+        bundle.readSpritesheet(buffer);
+        spritesheetImage.loadFromMemory(&buffer[0], buffer.size());
+        finished += 1;
+    });
+    std::thread fontThread([&]() {
+        bundle.readFile("font/LuckiestGuy.ttf", fontData);
+        finished += 1;
+    });
+    std::thread worldThread([&]() {
+        world = new World(&bundle);
+        world->loadMap(mapKey);
+        if (playback)
+            playback->seek(world, seekStep);
+        if (net) {
+            session = new RollbackSession(world, &bundle, *net);
+            session->connect();
+        }
+        finished += 1;
+    });
 
-            // find out if grounded
-            player->footContacts = 0;
-            float distFromEdge = 4.0f;
-            cpBB footBB = cpBBNew(
-                        pos.x - player->size.x / 2.0f + distFromEdge,
-                        pos.y + player->size.y / 2.0f + 1.0f,
-                        pos.x + player->size.x / 2.0f - distFromEdge,
-                        pos.y + player->size.y / 2.0f + 3.0f);
-            cpSpaceBBQuery(space, footBB, -1, 0, groundQueryCallback, player);
+    sf::Clock clock;
+    while (finished < loadingJobCount) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
+        }
+        if (window.isOpen()) {
+            drawLoading(window, finished / (float)loadingJobCount, clock.getElapsedTime());
+            window.display();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    spritesheetThread.join();
+    fontThread.join();
+    worldThread.join();
 
+    // the decoded pixels go away with spritesheetImage once uploaded
+    spritesheet.loadFromImage(spritesheetImage);
+    font.loadFromMemory(&fontData[0], fontData.size());
+}
 
-            cpVect curVel = cpBodyGetVel(player->body);
+// A bar that fills as loading jobs finish, with a block sliding along it so
+// it still moves while a single long job runs.
+void MainWindow::drawLoading(sf::RenderTarget &target, float progress, sf::Time elapsed)
+{
+    target.setView(target.getDefaultView());
+    target.clear(sf::Color(158, 204, 233, 255));
+
+    sf::Vector2f barSize(loadingBarWidth, loadingBarHeight);
+    sf::Vector2f barPos((windowWidth - barSize.x) / 2.0f, (windowHeight - barSize.y) / 2.0f);
+
+    sf::RectangleShape background(barSize);
+    background.setPosition(barPos);
+    background.setFillColor(sf::Color(0, 0, 0, 64));
+    target.draw(background);
+
+    sf::RectangleShape filled(sf::Vector2f(barSize.x * progress, barSize.y));
+    filled.setPosition(barPos);
+    filled.setFillColor(sf::Color(255, 255, 0));
+    target.draw(filled);
+
+    float slide = (sinf(elapsed.asSeconds() * 4.0f) + 1.0f) / 2.0f;
+    sf::RectangleShape block(sf::Vector2f(barSize.y, barSize.y));
+    block.setPosition(barPos.x + (barSize.x - barSize.y) * slide, barPos.y);
+    block.setFillColor(sf::Color(255, 255, 255, 160));
+    target.draw(block);
+}
 
-            float moveForce = (player->footContacts > 0) ? playerMoveForceGround : playerMoveForceAir;
-            if (player->xAxis < 0) {
-                if (curVel.x >= -maxPlayerSpeed) {
-                    cpBodyApplyImpulse(player->body, cpv(-moveForce, 0), cpvzero);
+// Steps the world at a fixed rate on its own thread and publishes a
+// snapshot after every batch of steps, so a slow frame on the render
+// thread does not hold up physics.
+void MainWindow::runSimulation()
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration timeStep = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<float>(world->timeStep));
+    Clock::time_point nextStep = Clock::now();
+    std::vector<PlayerInput> latchedInput;
+    std::vector<PlayerInput> localInput;
+
+    while (simRunning) {
+        Clock::time_point now = Clock::now();
+        // after a hitch, drop simulation time rather than trying to catch up
+        if (now - nextStep > maxStepsPerFrame * timeStep)
+            nextStep = now - maxStepsPerFrame * timeStep;
+
+        int seek = seekRequest.exchange(0);
+        if (seek != 0 && playback)
+            playback->seek(world, world->stepIndex + seek);
+
+        // a restore would break the replay being recorded or played
+        bool canQuickSave = !session && !playback && !recording;
+        if (quickSaveRequest.exchange(false) && canQuickSave)
+            world->saveState(quickSave);
+        if (quickLoadRequest.exchange(false) && canQuickSave && !quickSave.empty())
+            world->loadState(quickSave);
+
+        bool stalled = false;
+        while (nextStep <= now) {
+            // as late as possible, so a press reaches this very step
+            if (!playback)
+                inputPoller.latch(latchedInput);
+            if (session) {
+                // controller i drives our i-th player
+                const std::vector<int> &localPlayers = session->getLocalPlayers();
+                localInput.resize(localPlayers.size());
+                for (int i = 0; i < (int)localPlayers.size(); i += 1) {
+                    localInput[i] = latchedInput[i];
                 }
-            } else if (player->xAxis > 0) {
-                if (curVel.x <= maxPlayerSpeed) {
-                    cpBodyApplyImpulse(player->body, cpv(moveForce, 0), cpvzero);
+                if (!session->advance(localInput)) {
+                    // waiting on the peer; try again shortly
+                    stalled = true;
+                    break;
                 }
+                nextStep += std::chrono::duration_cast<Clock::duration>(timeStep * session->getStepScale());
+                continue;
             }
-
-
-            if (player->btnJump && player->footContacts > 0) {
-                player->jumpFrameCount = 1;
-            } else if (!player->btnJump && player->jumpFrameCount > 0) {
-                player->jumpFrameCount = 0;
-            }
-            if (player->jumpFrameCount > maxJumpFrames) {
-                player->jumpFrameCount = 0;
-            } else if (player->jumpFrameCount > 0) {
-                player->jumpFrameCount += 1;
-                cpBodyApplyImpulse(player->body, cpv(0, -jumpForce), cpvzero);
-            }
-
-            float scaleSign = sign(player->xAxis);
-            if (scaleSign != 0) {
-                sf::Vector2f bodyScale = player->sprite.getScale();
-                bodyScale.x = fabsf(bodyScale.x) * scaleSign;
-                player->sprite.setScale(bodyScale);
-
-                sf::Vector2f armScale = player->armSprite.getScale();
-                armScale.x = fabsf(armScale.x) * scaleSign;
-                player->armRotateOffset = (scaleSign == -1.0f) ? M_PI : 0;
-                player->armSprite.setScale(armScale);
-            }
-            if (player->xAxis != 0 || player->yAxis != 0) {
-                player->pointAngle = atan2(player->yAxis, player->xAxis);
-            }
-            player->aimUnit = cpv(cos(player->pointAngle), sin(player->pointAngle));
-            player->aimStartPos = cpvadd(pos, cpvmult(player->aimUnit, armLength));
-
-            if (player->btnFireGrapple && player->clawState == ClawStateRetracted) {
-                player->clawBody = cpSpaceAddBody(space, cpBodyNew(1.0f, INFINITY));
-                cpBodySetPos(player->clawBody, player->aimStartPos);
-                cpBodySetAngle(player->clawBody, player->pointAngle);
-                cpBodySetVel(player->clawBody, cpvadd(curVel, cpvmult(player->aimUnit, clawShootSpeed)));
-
-                player->clawShape = cpSpaceAddShape(space, cpCircleShapeNew(player->clawBody, clawRadius, cpvzero));
-                cpShapeSetFriction(player->clawShape, 0.0f);
-                cpShapeSetElasticity(player->clawShape, 0.0f);
-                cpShapeSetUserData(player->clawShape, &player->clawFixtureUserData);
-
-                player->slideJoint = cpSlideJointAlloc();
-                cpSlideJointInit(player->slideJoint, player->body, player->clawBody,
-                                 player->localAnchorPos, player->clawLocalAnchorPos, minClawDist, maxReelOutLength);
-                cpSpaceAddConstraint(space, &player->slideJoint->constraint);
-                setPlayerClawState(player, ClawStateAir);
-            } else if (player->btnFireGrapple && player->clawState == ClawStateAttached) {
-                playerReelClawOneFrame(player, false);
-            } else if (player->btnFireGrapple && player->clawState == ClawStateDetached) {
-                playerReelClawOneFrame(player, true);
-            } else if (player->btnUnhookGrapple && player->clawState == ClawStateDetached) {
-                playerReelClawOneFrame(player, true);
-            } else if (player->btnUnhookGrapple && (player->clawState == ClawStateAttached || player->clawState == ClawStateAir)) {
-                playerUnhookClaw(player);
-            } else if (player->btnReelOut && player->clawState == ClawStateAttached) {
-                playerReelOutClawOneFrame(player);
+            if (playback && !playback->playStep(world)) {
+                // hold the last frame once the replay runs out
+                nextStep = now + timeStep;
+                break;
             }
-
-            if (player->clawState != ClawStateRetracted) {
-                if (player->slideJoint->jnAcc < jnAccMin) {
-                    // too tense. give it some slack.
-                    float currentLength = cpSlideJointGetMax(&player->slideJoint->constraint);
-                    float newMax = currentLength + getPlayerReelInSpeed(player);
-                    cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
-                    player->slideJoint->jnAcc = jnAccMin;
+            if (!playback) {
+                for (int i = 0; i < (int)latchedInput.size(); i += 1) {
+                    world->playerState.input[i] = latchedInput[i];
                 }
             }
-
-
-            if (i == 0 && player->slideJoint) {
-                std::stringstream ss;
-                ss << "xAxis: " << player->xAxis << " footContacts: " << player->footContacts <<
-                      " jnAcc: " << player->slideJoint->jnAcc;
-                physDebugText.setString(ss.str());
-            }
-
-
-            Animation *currentAnim = NULL;
-            bool loop = true;
-            if (player->footContacts > 0) {
-                if (curVel.x != 0) {
-                    currentAnim = &walkingAnim;
-                } else {
-                    currentAnim = &stillAnim;
-                }
-            } else {
-                currentAnim = &jumpingAnim;
-                loop = false;
-            }
-            player->sprite.setLooped(loop);
-            if (player->sprite.getAnimation() != currentAnim) {
-                player->sprite.setAnimation(*currentAnim);
-                player->sprite.play();
-            }
-            player->armSprite.setPosition(pos.x, pos.y);
-            if (player->xAxis != 0 || player->yAxis != 0)
-                player->armSprite.setRotation(toDegrees(player->armRotateOffset + player->pointAngle));
-
+            if (recording)
+                recording->recordStep(world);
+            world->step();
+            nextStep += timeStep;
         }
 
-        for (int i = 0; i < (int)platforms.size(); i += 1) {
-            Platform *platform = platforms[i];
-            window.draw(platform->sprite);
-        }
-        for (int i = 0; i < (int)players.size(); i += 1) {
-            Player *player = players[i];
-            player->sprite.update(frameTime);
-            window.draw(player->sprite);
-            window.draw(player->armSprite);
-            if (player->clawState != ClawStateRetracted) {
-                cpVect clawPos = player->clawBody->p;
-                player->clawSprite.setPosition(clawPos.x, clawPos.y);
-                player->clawSprite.setRotation(toDegrees(player->clawBody->a));
-                window.draw(player->clawSprite);
-
-                sf::Vertex line[] =
-                {
-                    sf::Vertex(sf::Vector2f(player->aimStartPos.x, player->aimStartPos.y), ropeColor),
-                    sf::Vertex(sf::Vector2f(clawPos.x, clawPos.y), ropeColor)
-                };
-
-                window.draw(line, 2, sf::Lines);
-            }
-        }
-        window.draw(physDebugText);
+        // online, the world shown runs ahead of the one confirmed
+        snapshots.back().capture(session ? *session->getWorld() : *world, nextStep - timeStep);
+        snapshots.publish();
 
-        window.display();
+        if (stalled)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        else
+            std::this_thread::sleep_until(nextStep);
     }
-
-    return 0;
 }
 
-void MainWindow::loadMap()
+void MainWindow::pollEvents(sf::RenderWindow &window)
 {
-    map = new Tmx::Map();
-    map->ParseText(getResourceString("text/basic.tmx"));
-    if (map->HasError()) {
-        std::cerr << "error parsing map: " << map->GetErrorText() << "\n";
-        std::exit(1);
-    }
-    for (int i = 0; i < map->GetNumObjectGroups(); i += 1) {
-        const Tmx::ObjectGroup *objectGroup = map->GetObjectGroup(i);
-        for (int j = 0; j < objectGroup->GetNumObjects(); j += 1) {
-            const Tmx::Object *object = objectGroup->GetObject(j);
-            cpVect size = cpv(object->GetWidth(), object->GetHeight());
-            cpVect pos = cpv(object->GetX() + size.x / 2, object->GetY() + size.y / 2);
-            const Tmx::PropertySet &properties = object->GetProperties();
-
-            if (object->GetName().compare("Platform") == 0) {
-                std::string img = properties.GetStringProperty("img");
-                bool canGrapple = !!properties.GetIntProperty("canGrapple", 1);
-                addPlatform(pos, size, img, canGrapple);
-            } else if (object->GetName().compare("Start") == 0) {
-                int index = properties.GetIntProperty("player");
-                initPlayer(index, pos);
-            } else {
-                std::cerr << "unrecognized object name: " << object->GetName() << "\n";
-                std::exit(1);
+    Profiler::Zone zone("events");
+
+    sf::Event event;
+    while (nextEvent(window, event))
+    {
+        switch (event.type) {
+        case sf::Event::Closed:
+            window.close();
+            break;
+        case sf::Event::GainedFocus:
+            inputPoller.setKeyboardEnabled(true);
+            break;
+        case sf::Event::LostFocus:
+            inputPoller.setKeyboardEnabled(false);
+            break;
+        case sf::Event::KeyPressed:
+            switch (event.key.code) {
+            case sf::Keyboard::Escape:
+                window.close();
+                break;
+            case sf::Keyboard::Left:
+                seekRequest -= replaySeekSteps;
+                break;
+            case sf::Keyboard::Right:
+                seekRequest += replaySeekSteps;
+                break;
+            case sf::Keyboard::F5:
+                quickSaveRequest = true;
+                break;
+            case sf::Keyboard::F9:
+                quickLoadRequest = true;
+                break;
+            case sf::Keyboard::F3:
+                showProfiler = !showProfiler;
+                Profiler::setEnabled(showProfiler || Profiler::isTracing());
+                break;
+            default:
+                break;
             }
+            break;
+        default:
+            break;
         }
     }
 }
 
-std::string MainWindow::getResourceString(const std::string &key)
+// Polling the window refreshes sf::Joystick, which the input thread reads.
+bool MainWindow::nextEvent(sf::RenderWindow &window, sf::Event &event)
 {
-    RuckSackFileEntry *entry = rucksack_bundle_find_file(bundle, key.c_str(), key.size());
-
-    if (!entry) {
-        std::cerr << "Could not find resource '" << key << "' in bundle.\n";
-        std::exit(1);
-    }
-
-    long size = rucksack_file_size(entry);
-    std::string contents;
-    contents.resize(size);
-    int err = rucksack_file_read(entry, reinterpret_cast<unsigned char *>(&contents[0]));
-
-    if (err) {
-        std::cerr << "Error reading '" << key << "' resource: " << rucksack_err_str(err) << "\n";
-        std::exit(1);
-    }
-
-    return contents;
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    return window.pollEvent(event);
 }
 
-sf::IntRect MainWindow::imageInfoToTextureRect(RuckSackImage *imageInfo)
+void MainWindow::initSprites()
 {
-    return sf::IntRect(imageInfo->x, spritesheet.getSize().y - imageInfo->y - imageInfo->height,
-                       imageInfo->width, imageInfo->height);
-}
-
-void MainWindow::loadAnimation(Animation &animation, const std::vector<std::string> &list)
-{
-    animation.setSpriteSheet(spritesheet);
-    for (int i = 0; i < (int)list.size(); i += 1) {
-        std::string frame = list[i];
-        std::map<std::string, RuckSackImage *>::iterator it = imageMap.find(frame);
-        if (it == imageMap.end()) {
-            std::cerr << "Missing image: " << frame << "\n";
-            std::exit(1);
-        }
-        RuckSackImage *imageInfo = it->second;
-        animation.addFrame(imageInfoToTextureRect(imageInfo));
+    batch.setTexture(spritesheet, imageTextureRect(ImgWhite));
+
+    armNormalRect = imageTextureRect(ImgArm);
+    armFlungRect = imageTextureRect(ImgArmFlung);
+    clawInAirRect = imageTextureRect(ImgClaw);
+    clawDetachedRect = imageTextureRect(ImgClawRetracted);
+    clawAttachedRect = imageTextureRect(ImgClawAttached);
+
+    RuckSackImage *imageInfo = bundle.getImage(ImgMan);
+    RuckSackImage *armImageInfo = bundle.getImage(ImgArm);
+    RuckSackImage *clawOpenImageInfo = bundle.getImage(ImgClaw);
+    for (int i = 0; i < (int)world->players.size(); i += 1) {
+        PlayerSprite *playerSprite = new PlayerSprite();
+        playerSprite->body.setOrigin(imageInfo->anchor_x, imageInfo->anchor_y);
+        animator.add(sf::seconds(animFrameTime));
+
+        playerSprite->armSprite.setTexture(spritesheet);
+        playerSprite->armSprite.setOrigin(armImageInfo->anchor_x, armImageInfo->anchor_y);
+        playerSprite->armSprite.setTextureRect(armNormalRect);
+
+        playerSprite->clawSprite.setTexture(spritesheet);
+        playerSprite->clawSprite.setOrigin(clawOpenImageInfo->anchor_x, clawOpenImageInfo->anchor_y);
+        playerSprite->clawSprite.setTextureRect(clawInAirRect);
+
+        playerSprites.push_back(playerSprite);
     }
 }
 
-void MainWindow::setPlayerClawState(MainWindow::Player *player, MainWindow::ClawState state)
+void MainWindow::buildStaticLayer()
 {
-    player->clawState = state;
-    switch (state) {
-    case ClawStateRetracted:
-        player->clawSprite.setTextureRect(clawInAirRect);
-        player->armSprite.setTextureRect(armNormalRect);
-        break;
-    case ClawStateAir:
-        player->clawSprite.setTextureRect(clawInAirRect);
-        player->armSprite.setTextureRect(armFlungRect);
-        break;
-    case ClawStateAttached:
-        player->clawSprite.setTextureRect(clawAttachedRect);
-        player->armSprite.setTextureRect(armFlungRect);
-        break;
-    case ClawStateDetached:
-        player->clawSprite.setTextureRect(clawDetachedRect);
-        player->armSprite.setTextureRect(armFlungRect);
-        break;
+    std::vector<sf::Sprite> platformSprites;
+    for (int i = 0; i < (int)mapLayout.platforms.size(); i += 1) {
+        const MapLayout::Platform *platform = &mapLayout.platforms[i];
+        RuckSackImage *imageInfo = platform->image;
+        sf::Sprite sprite;
+        sprite.setTexture(spritesheet);
+        sprite.setTextureRect(imageInfoToTextureRect(imageInfo));
+        sprite.setOrigin(imageInfo->anchor_x, imageInfo->anchor_y);
+        sprite.setPosition(platform->pos.x, platform->pos.y);
+        sprite.setScale(platform->size.x / (float)imageInfo->width, platform->size.y / (float)imageInfo->height);
+        platformSprites.push_back(sprite);
     }
 
-}
-
-void MainWindow::onPostSolveCollision(cpArbiter *arb)
-{
-    cpShape *a;
-    cpShape *b;
-    cpArbiterGetShapes(arb, &a, &b);
-
-    FixtureIdent *identA = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(a));
-    FixtureIdent *identB = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(b));
-
-    if (identA) {
-        switch (identA->type) {
-        case ClawFixture:
-            handleClawHit(identA->player, arb, b);
-            return;
-        case PlatformFixture:
-            return;
-        }
-        std::cerr << "Unrecognized fixture identification type: " << identA->type << "\n";
-        assert(0);
-    }
-    if (identB) {
-        switch (identB->type) {
-        case ClawFixture:
-            handleClawHit(identA->player, arb, a);
-            return;
-        case PlatformFixture:
-            return;
+    TileMap tileMap;
+    tileMap.create(spritesheet, mapLayout.arenaWidth, mapLayout.arenaHeight);
+    for (int i = 0; i < (int)mapLayout.tileLayers.size(); i += 1) {
+        const World::TileLayer *layer = &mapLayout.tileLayers[i];
+        for (int y = 0; y < layer->height; y += 1) {
+            for (int x = 0; x < layer->width; x += 1) {
+                RuckSackImage *imageInfo = layer->tiles[y * layer->width + x];
+                if (imageInfo) {
+                    sf::FloatRect rect(x * mapLayout.tileWidth, y * mapLayout.tileHeight,
+                                       mapLayout.tileWidth, mapLayout.tileHeight);
+                    tileMap.add(rect, imageInfoToTextureRect(imageInfo));
+                }
+            }
         }
-        std::cerr << "Unrecognized fixture identification type: " << identB->type << "\n";
-        assert(0);
     }
+
+    staticLayer.build(platformSprites, tileMap, mapLayout.arenaWidth, mapLayout.arenaHeight);
+    camera.setArenaSize(mapLayout.arenaWidth, mapLayout.arenaHeight);
 }
 
-void MainWindow::handleClawHit(MainWindow::Player *player, cpArbiter *arb, cpShape *otherShape)
+void MainWindow::updateSprites(const RenderSnapshot &snapshot)
 {
-    if (player->clawState != ClawStateAir || player->queuePivotJoint)
-        return;
-
-    FixtureIdent *ident = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(otherShape));
-    bool canGrapple = !ident || ident->canGrapple;
+    Profiler::Zone zone("sprites");
+
+    // alpha is how far we are between the previous physics state and the
+    // current one.
+    std::chrono::duration<float> sinceStep = std::chrono::steady_clock::now() - snapshot.stepTime;
+    float alpha = std::max(0.0f, std::min(sinceStep.count() / snapshot.timeStep, 1.0f));
+
+    for (int i = 0; i < (int)snapshot.players.size(); i += 1) {
+        const RenderSnapshot::Player &player = snapshot.players[i];
+        PlayerSprite *playerSprite = playerSprites[i];
+        cpVect pos = cpvlerp(player.prevPos, player.pos, alpha);
+
+        playerSprite->body.setPosition(pos.x, pos.y);
+        playerSprite->body.setRotation(toDegrees(player.angle));
+
+        sf::Vector2f bodyScale = playerSprite->body.getScale();
+        bodyScale.x = fabsf(bodyScale.x) * player.facing;
+        playerSprite->body.setScale(bodyScale);
+
+        sf::Vector2f armScale = playerSprite->armSprite.getScale();
+        armScale.x = fabsf(armScale.x) * player.facing;
+        playerSprite->armSprite.setScale(armScale);
+        float armRotateOffset = (player.facing == -1.0f) ? M_PI : 0;
+        playerSprite->armSprite.setPosition(pos.x, pos.y);
+        playerSprite->armSprite.setRotation(toDegrees(armRotateOffset + player.pointAngle));
+
+        switch (player.clawState) {
+        case World::ClawStateRetracted:
+            playerSprite->clawSprite.setTextureRect(clawInAirRect);
+            playerSprite->armSprite.setTextureRect(armNormalRect);
+            break;
+        case World::ClawStateAir:
+            playerSprite->clawSprite.setTextureRect(clawInAirRect);
+            playerSprite->armSprite.setTextureRect(armFlungRect);
+            break;
+        case World::ClawStateAttached:
+            playerSprite->clawSprite.setTextureRect(clawAttachedRect);
+            playerSprite->armSprite.setTextureRect(armFlungRect);
+            break;
+        case World::ClawStateDetached:
+            playerSprite->clawSprite.setTextureRect(clawDetachedRect);
+            playerSprite->armSprite.setTextureRect(armFlungRect);
+            break;
+        }
 
-    if (canGrapple) {
-        cpContactPointSet pointSet = cpArbiterGetContactPointSet(arb);
+        if (player.clawState != World::ClawStateRetracted) {
+            cpVect clawPos = cpvlerp(player.prevClawPos, player.clawPos, alpha);
+            playerSprite->clawSprite.setPosition(clawPos.x, clawPos.y);
+            playerSprite->clawSprite.setRotation(toDegrees(player.clawAngle));
 
-        // average the contact points to get a single value
-        float scaleVal = 1 / (float) pointSet.count;
-        cpVect pt = cpvzero;
-        for (int i = 0; i < pointSet.count; i += 1) {
-            pt = cpvadd(pt, cpvmult(pointSet.points[i].point, scaleVal));
+            cpVect ropeStart = cpvlerp(player.prevAimStartPos, player.aimStartPos, alpha);
+            playerSprite->ropeStart = sf::Vector2f(ropeStart.x, ropeStart.y);
+            playerSprite->ropeEnd = sf::Vector2f(clawPos.x, clawPos.y);
         }
 
-        cpVect shapeAnchor = cpvsub(pt, otherShape->body->p);
-        cpVect clawAnchor = cpvsub(pt, player->clawBody->p);
+        // formatting text allocates, so the debug text only updates while the
+        // overlay is up
+        if (i == 0 && showProfiler && player.clawState != World::ClawStateRetracted) {
+            std::stringstream ss;
+            ss << "xAxis: " << player.xAxis << " footContacts: " << player.footContacts <<
+                  " jnAcc: " << player.jnAcc;
+            physDebugText.setString(ss.str());
+        }
 
-        player->pivotJoint = cpPivotJointAlloc();
-        cpPivotJointInit(player->pivotJoint, player->clawBody, otherShape->body, clawAnchor, shapeAnchor);
-        player->queuePivotJoint = true;
-    } else {
-        // kill velocity of the grapple body
-        cpBodySetVel(player->clawBody, cpvzero);
-        setPlayerClawState(player, ClawStateDetached);
+        Animation *currentAnim = NULL;
+        bool loop = true;
+        if (player.footContacts > 0) {
+            if (player.vel.x != 0) {
+                currentAnim = &walkingAnim;
+            } else {
+                currentAnim = &stillAnim;
+            }
+        } else {
+            currentAnim = &jumpingAnim;
+            loop = false;
+        }
+        animator.play(i, *currentAnim, loop);
     }
 }
 
-void MainWindow::playerRetractClaw(MainWindow::Player *player)
+void MainWindow::draw(sf::RenderTarget &target, const RenderSnapshot &snapshot, sf::Time frameTime)
 {
-    assert(player->clawState != ClawStateRetracted);
-
-    if (player->clawState == ClawStateAttached)
-        playerUnhookClaw(player);
-
-    setPlayerClawState(player, ClawStateRetracted);
-
-    cpSpaceRemoveConstraint(space, &player->slideJoint->constraint);
-    cpConstraintDestroy(&player->slideJoint->constraint);
-    player->slideJoint = NULL;
+    {
+        Profiler::Zone zone("animation");
+        animator.update(frameTime);
+    }
 
-    cpSpaceRemoveShape(space, player->clawShape);
-    cpShapeDestroy(player->clawShape);
-    player->clawShape = NULL;
+    {
+        Profiler::Zone zone("draw static");
+        target.draw(staticLayer);
+    }
 
-    cpSpaceRemoveBody(space, player->clawBody);
-    cpBodyDestroy(player->clawBody);
-    player->clawBody = NULL;
+    // everything else but the text samples the spritesheet, so it all goes
+    // out in one draw call, minus whatever is off screen.
+    Profiler::Zone batchZone("draw batch");
+    sf::FloatRect visible = camera.getVisibleRect();
+    batch.clear();
+    for (int i = 0; i < (int)snapshot.players.size(); i += 1) {
+        PlayerSprite *playerSprite = playerSprites[i];
+        const sf::Transform &bodyTransform = playerSprite->body.getTransform();
+        const sf::Vertex *bodyQuad = animator.getQuad(i);
+        if (bodyQuad && bodyTransform.transformRect(animator.getLocalBounds(i)).intersects(visible))
+            batch.addQuad(bodyTransform, bodyQuad);
+        if (playerSprite->armSprite.getGlobalBounds().intersects(visible))
+            batch.add(playerSprite->armSprite);
+        if (snapshot.players[i].clawState != World::ClawStateRetracted) {
+            if (playerSprite->clawSprite.getGlobalBounds().intersects(visible))
+                batch.add(playerSprite->clawSprite);
+
+            sf::Vector2f start = playerSprite->ropeStart;
+            sf::Vector2f end = playerSprite->ropeEnd;
+            sf::FloatRect ropeBounds(std::min(start.x, end.x) - ropeThickness, std::min(start.y, end.y) - ropeThickness,
+                                     fabsf(end.x - start.x) + ropeThickness * 2.0f,
+                                     fabsf(end.y - start.y) + ropeThickness * 2.0f);
+            if (ropeBounds.intersects(visible))
+                batch.addLine(start, end, ropeThickness, ropeColor);
+        }
+    }
+    target.draw(batch);
 }
 
-void MainWindow::playerUnhookClaw(MainWindow::Player *player)
+void MainWindow::drawText(sf::RenderTarget &target)
 {
-    setPlayerClawState(player, ClawStateDetached);
-
-    if (player->pivotJoint) {
-        cpSpaceRemoveConstraint(space, &player->pivotJoint->constraint);
-        cpConstraintDestroy(&player->pivotJoint->constraint);
-        player->pivotJoint = NULL;
+    Profiler::Zone zone("draw text");
+    target.setView(target.getDefaultView());
+    if (showProfiler) {
+        updateProfilerText();
+        target.draw(physDebugText);
+        target.draw(profilerText);
     }
 }
 
-void MainWindow::playerReelClawOneFrame(MainWindow::Player *player, bool retract)
+void MainWindow::updateProfilerText()
 {
-    cpVect clawPos = player->clawBody->p;
-    float clawDist = cpvlength(cpvsub(clawPos, cpBodyGetPos(player->body)));
-    if (clawDist <= retractClawDist) {
-        if (retract)
-            playerRetractClaw(player);
-    } else {
-        // prevent the claw from going back out once it goes in
-        float currentLength = cpSlideJointGetMax(&player->slideJoint->constraint);
-        float autoDelta = currentLength - std::max(clawDist, retractClawDist);
-        float delta = std::max(autoDelta, getPlayerReelInSpeed(player));
-        float newMax = std::max(currentLength - delta, minClawDist);
-        cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
-
+    int version = Profiler::statsVersion();
+    if (version == profilerStatsVersion)
+        return;
+    profilerStatsVersion = version;
+
+    std::vector<Profiler::ZoneStats> stats = Profiler::getStats();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "ms per frame over " << Profiler::statsWindow << " frames (avg / max)\n";
+    for (int i = 0; i < (int)stats.size(); i += 1) {
+        ss << stats[i].name << ": " << stats[i].avgMs << " / " << stats[i].maxMs << "\n";
+    }
+    FramePacer::Stats frameStats = pacer.getStats();
+    ss << "frames (" << pacingModeName(pacing) << ", last " << frameStats.frames << "): " <<
+          frameStats.meanMs << " / " << frameStats.maxMs << ", std dev " << frameStats.stdDevMs << ", " <<
+          frameStats.missed << " late\n";
+    InputPoller::LatencyStats latency = inputPoller.getLatency();
+    if (latency.presses > 0) {
+        ss << "input to step over " << latency.presses << " presses: " <<
+              (latency.totalMs / latency.presses) << " / " << latency.maxMs << "\n";
     }
+    profilerText.setString(ss.str());
 }
 
-void MainWindow::playerReelOutClawOneFrame(MainWindow::Player *player)
+sf::IntRect MainWindow::imageInfoToTextureRect(RuckSackImage *imageInfo)
 {
-    float currentLength = cpSlideJointGetMax(&player->slideJoint->constraint);
-    float newMax = std::min(currentLength + getPlayerReelInSpeed(player), maxReelOutLength);
-    cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
+    return sf::IntRect(imageInfo->x, spritesheet.getSize().y - imageInfo->y - imageInfo->height,
+                       imageInfo->width, imageInfo->height);
 }
 
-float MainWindow::getPlayerReelInSpeed(MainWindow::Player *player)
+sf::IntRect MainWindow::imageTextureRect(ImageId id)
 {
-    return (player->clawState == ClawStateAttached) ? clawReelInSpeedAttached : clawReelInSpeedDetached;
+    return imageInfoToTextureRect(bundle.getImage(id));
 }
 
-void MainWindow::addPlatform(cpVect pos, cpVect size, std::string imgName, bool canGrapple)
+void MainWindow::loadAnimation(Animation &animation, const std::vector<ImageId> &list)
 {
-    Platform *platform = new Platform(this);
-
-    platform->body = cpBodyNewStatic();
-    cpBodySetPos(platform->body, pos);
-    platform->shape = cpBoxShapeNew(platform->body, size.x, size.y);
-    platform->ident.canGrapple = canGrapple;
-    cpShapeSetUserData(platform->shape, &platform->ident);
-    cpShapeSetFriction(platform->shape, 0.8f);
-    cpSpaceAddShape(space, platform->shape);
-
-
-    platform->sprite.setTexture(spritesheet);
-
-    std::map<std::string, RuckSackImage *>::iterator it = imageMap.find(imgName);
-    if (it == imageMap.end()) {
-        std::cerr << "Missing image: " << imgName << "\n";
-        std::exit(1);
+    animation.setSpriteSheet(spritesheet);
+    for (int i = 0; i < (int)list.size(); i += 1) {
+        animation.addFrame(imageTextureRect(list[i]));
     }
-    RuckSackImage *imageInfo = it->second;
-    platform->sprite.setTextureRect(imageInfoToTextureRect(imageInfo));
-    platform->sprite.setOrigin(imageInfo->anchor_x, imageInfo->anchor_y);
-    platform->sprite.setPosition(pos.x, pos.y);
-    platform->sprite.setScale(size.x / (float)imageInfo->width, size.y / (float)imageInfo->height);
-
-    platforms.push_back(platform);
-}
-
-void MainWindow::initPlayer(int index, cpVect pos)
-{
-    Player *player = players[index];
-    RuckSackImage *imageInfo = imageMap.at("img/man.png");
-    player->sprite.setOrigin(imageInfo->anchor_x, imageInfo->anchor_y);
-    player->localAnchorPos = cpv(imageInfo->anchor_x, imageInfo->anchor_y);
-    player->size = cpv(imageInfo->width, imageInfo->height);
-
-    RuckSackImage *armImageInfo = imageMap.at("img/arm.png");
-    player->armSprite.setTexture(spritesheet);
-    player->armSprite.setOrigin(armImageInfo->anchor_x, armImageInfo->anchor_y);
-    armNormalRect = imageInfoToTextureRect(armImageInfo);
-    player->armSprite.setTextureRect(armNormalRect);
-    RuckSackImage *armFlungImageInfo = imageMap.at("img/arm-flung.png");
-    armFlungRect = imageInfoToTextureRect(armFlungImageInfo);
-
-    RuckSackImage *clawOpenImageInfo = imageMap.at("img/claw.png");
-    player->clawSprite.setTexture(spritesheet);
-    player->clawSprite.setOrigin(clawOpenImageInfo->anchor_x, clawOpenImageInfo->anchor_y);
-    clawInAirRect = imageInfoToTextureRect(clawOpenImageInfo);
-    clawRadius = clawOpenImageInfo->width / 2.0f;
-    RuckSackImage *clawClosedImageInfo = imageMap.at("img/claw-retracted.png");
-    clawDetachedRect = imageInfoToTextureRect(clawClosedImageInfo);
-    RuckSackImage *clawAttachedImageInfo = imageMap.at("img/claw-attached.png");
-    clawAttachedRect = imageInfoToTextureRect(clawAttachedImageInfo);
-    player->clawLocalAnchorPos = cpv(clawOpenImageInfo->anchor_x, clawOpenImageInfo->anchor_y);
-
-    player->body = cpSpaceAddBody(space, cpBodyNew(20.0f, INFINITY));
-    cpBodySetPos(player->body, cpv(pos.x, pos.y));
-
-    player->shape = cpSpaceAddShape(space, cpBoxShapeNew(player->body, player->size.x, player->size.y));
-    cpShapeSetFriction(player->shape, 0.8f);
-}
-
-
-MainWindow::Platform::Platform(MainWindow *window)
-{
-    ident.window = window;
-    ident.type = PlatformFixture;
-    ident.player = NULL;
-    ident.canGrapple = true;
 }
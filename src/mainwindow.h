@@ -2,14 +2,26 @@
 #define MAINWINDOW_H
 
 #include <SFML/Graphics.hpp>
-#include <chipmunk/chipmunk.h>
 
-#include <rucksack.h>
-#include <map>
-#include <tmxparser/Tmx.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
 
-#include "animatedsprite.h"
 #include "animation.h"
+#include "camera.h"
+#include "framepacer.h"
+#include "inputpoller.h"
+#include "rendersnapshot.h"
+#include "replay.h"
+#include "rollback.h"
+#include "resourcebundle.h"
+#include "spritebatch.h"
+#include "spriteanimator.h"
+#include "staticlayer.h"
+#include "tilemap.h"
+#include "triplebuffer.h"
+#include "world.h"
 
 
 class MainWindow
@@ -17,94 +29,66 @@ class MainWindow
 public:
     MainWindow();
 
+    std::string mapKey;
+    // play this back instead of reading joysticks
+    Replay *playback;
+    int seekStep;
+    Replay *recording;
+    // play online; the local controllers drive this side's players
+    const NetConfig *net;
+    PacingMode pacing;
+    // the cap for PacingCapped, and what late frames are counted against
+    int fps;
+
     int start();
 
 private:
 
-
-    enum FixtureIdentType {
-        ClawFixture,
-        PlatformFixture,
-    };
-
-    class Player;
-    struct FixtureIdent {
-        FixtureIdentType type;
-        MainWindow *window;
-        Player *player;
-        bool canGrapple;
-    };
-
-    enum ClawState {
-        ClawStateRetracted,
-        ClawStateAir,
-        ClawStateAttached,
-        ClawStateDetached,
-    };
-
-    class Player {
+    class PlayerSprite {
     public:
-        int index;
-
-        float xAxis;
-        float yAxis;
-        bool btnJump;
-        bool btnFireGrapple;
-        bool btnUnhookGrapple;
-        bool btnReelOut;
-
-        AnimatedSprite sprite;
+        // the body's frames come from animator, at the player's index
+        sf::Transformable body;
         sf::Sprite armSprite;
         sf::Sprite clawSprite;
-        ClawState clawState = ClawStateRetracted;
-        cpBody *clawBody = NULL;
-        cpShape *clawShape = NULL;
-        FixtureIdent clawFixtureUserData;
-        cpVect aimStartPos; // where the claw will be created
-        cpVect aimUnit; // unit vector pointing where aiming
-        float pointAngle = 0.0f;
-        cpVect localAnchorPos;
-        cpVect clawLocalAnchorPos;
-        cpSlideJoint *slideJoint = NULL;
-        cpPivotJoint *pivotJoint = NULL;
-        bool queuePivotJoint = false;
-
-        cpBody *body = NULL;
-        cpShape *shape = NULL;
-        cpVect size;
-        int footContacts = 0;
-        int jumpFrameCount = 0;
-        float armRotateOffset = 0;
-
-        Player(int index, MainWindow *window);
-        void resetButtons();
-    };
-
-    class Platform {
-    public:
-        sf::Sprite sprite;
-        cpShape *shape;
-        cpBody *body;
-        FixtureIdent ident;
-        Platform(MainWindow *window);
+        sf::Vector2f ropeStart;
+        sf::Vector2f ropeEnd;
     };
 
+    ResourceBundle bundle;
+    // owned by the simulation thread while it runs
+    World *world = NULL;
+    RollbackSession *session = NULL;
+
+    TripleBuffer<RenderSnapshot> snapshots;
+    std::atomic<bool> simRunning;
+    // replay steps to seek by, added up until the simulation thread acts
+    std::atomic<int> seekRequest;
+    // F5 and F9, for offline play only
+    std::atomic<bool> quickSaveRequest;
+    std::atomic<bool> quickLoadRequest;
+    std::vector<unsigned char> quickSave;
+    InputPoller inputPoller;
+    // held around anything that touches sf::Joystick state
+    std::mutex deviceMutex;
+
+    FramePacer pacer;
+
+    std::vector<PlayerSprite *> playerSprites;
+    Camera camera;
+    MapLayout mapLayout;
+    StaticLayer staticLayer;
 
-    float arenaWidth;
-    float arenaHeight;
-
-    cpSpace *space;
-    std::vector<Player*> players;
-    std::vector<Platform *> platforms;
-
-    RuckSackBundle *bundle;
-    std::map<std::string, RuckSackImage *> imageMap;
-
-    Tmx::Map *map = NULL;
     sf::Font font;
+    // sf::Font reads from this lazily, so it lives as long as the font
+    std::vector<unsigned char> fontData;
     sf::Text physDebugText;
+    sf::Text profilerText;
+    bool showProfiler;
+    int profilerStatsVersion;
 
     sf::Texture spritesheet;
+    SpriteBatch batch;
+    SpriteAnimator animator;
     Animation walkingAnim;
     Animation jumpingAnim;
     Animation stillAnim;
@@ -113,38 +97,30 @@ private:
     sf::IntRect clawInAirRect;
     sf::IntRect clawDetachedRect;
     sf::IntRect clawAttachedRect;
-    float clawRadius;
-    float armLength;
     sf::IntRect armFlungRect;
     sf::IntRect armNormalRect;
 
 
 
     sf::Color ropeColor;
-
-    void loadMap();
-
-    std::string getResourceString(const std::string &key);
-
-    void addPlatform(cpVect pos, cpVect size, std::string img, bool canGrapple);
-    void initPlayer(int index, cpVect pos);
+    float ropeThickness;
+
+    void loadAssets(sf::RenderWindow &window);
+    void drawLoading(sf::RenderTarget &target, float progress, sf::Time elapsed);
+    void runSimulation();
+    void pollEvents(sf::RenderWindow &window);
+    bool nextEvent(sf::RenderWindow &window, sf::Event &event);
+    void initSprites();
+    void buildStaticLayer();
+    void updateSprites(const RenderSnapshot &snapshot);
+    void draw(sf::RenderTarget &target, const RenderSnapshot &snapshot, sf::Time frameTime);
+    void drawText(sf::RenderTarget &target);
+    void updateProfilerText();
 
     sf::IntRect imageInfoToTextureRect(RuckSackImage *imageInfo);
+    sf::IntRect imageTextureRect(ImageId id);
 
-    void loadAnimation(Animation &animation, const std::vector<std::string> &list);
-
-    void setPlayerClawState(Player *player, ClawState state);
-
-    void onPostSolveCollision(cpArbiter *arb);
-    void handleClawHit(Player *player, cpArbiter *arb, cpShape *otherShape);
-    void playerRetractClaw(Player *player);
-    void playerUnhookClaw(Player *player);
-    void playerReelClawOneFrame(Player *player, bool retract);
-    void playerReelOutClawOneFrame(Player *player);
-    float getPlayerReelInSpeed(Player *player);
-
-    static void groundQueryCallback(cpShape *shape, void *data);
-    static void postSolveCollisionCallback(cpArbiter *arb, cpSpace *space, void *data);
+    void loadAnimation(Animation &animation, const std::vector<ImageId> &list);
 };
 
 #endif // MAINWINDOW_H
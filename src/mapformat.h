@@ -0,0 +1,60 @@
+#ifndef MAPFORMAT_H
+#define MAPFORMAT_H
+
+#include <stdint.h>
+
+// Maps are compiled from .tmx by grapple_mapc at build time so that loading
+// one is a single read with no XML. A compiled map is, in order:
+//
+//     MapHeader
+//     platformCount MapPlatform
+//     startCount MapStart
+//     tileLayerCount times: MapTileLayer, then width * height uint16_t
+//         ImageIds in row order, mapNoImage where there is no tile
+//
+// The structs are written as they are in memory, in native byte order, so a
+// map is only read back by the same build. That is needed anyway, since
+// ImageIds change whenever assets.json does.
+
+static const char mapMagic[4] = {'G', 'M', 'A', 'P'};
+static const uint32_t mapFormatVersion = 2;
+static const uint16_t mapNoImage = 0xffff;
+// starts are numbered 0 to startCount - 1, one each
+static const int mapMaxPlayers = 16;
+
+struct MapHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width; // in pixels
+    uint32_t height;
+    uint32_t tileWidth;
+    uint32_t tileHeight;
+    uint32_t platformCount;
+    uint32_t startCount;
+    uint32_t tileLayerCount;
+};
+
+// Solid tiles come out as platforms too, already merged into rectangles,
+// with image set to -1.
+struct MapPlatform {
+    float x; // center
+    float y;
+    float width;
+    float height;
+    int32_t image; // ImageId
+    uint32_t canGrapple;
+};
+
+struct MapStart {
+    int32_t player;
+    float x; // center
+    float y;
+};
+
+struct MapTileLayer {
+    uint32_t width; // in tiles
+    uint32_t height;
+    uint32_t visible;
+};
+
+#endif // MAPFORMAT_H
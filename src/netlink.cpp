@@ -0,0 +1,85 @@
+#include "netlink.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+NetLink::NetLink(const NetConfig &config) :
+    config(config),
+    peerAddress(config.peerHost),
+    shimState(config.shimSeed ? config.shimSeed : 1),
+    receiveBuffer(sf::UdpSocket::MaxDatagramSize)
+{
+    if (peerAddress == sf::IpAddress::None) {
+        std::cerr << "unable to resolve " << config.peerHost << "\n";
+        std::exit(1);
+    }
+    if (socket.bind(config.port) != sf::Socket::Done) {
+        std::cerr << "unable to listen on UDP port " << config.port << "\n";
+        std::exit(1);
+    }
+    socket.setBlocking(false);
+}
+
+void NetLink::send(const std::vector<unsigned char> &packet)
+{
+    if (config.latencyMs == 0 && config.jitterMs == 0 && config.loss == 0.0f) {
+        sendNow(packet);
+        return;
+    }
+    if (nextShimFloat() < config.loss)
+        return;
+
+    int delayMs = config.latencyMs + (int)(nextShimFloat() * config.jitterMs);
+    Delayed entry;
+    entry.sendTime = Clock::now() + std::chrono::milliseconds(delayMs);
+    entry.packet = packet;
+    delayed.push_back(entry);
+    flush();
+}
+
+bool NetLink::receive(std::vector<unsigned char> &packet)
+{
+    for (;;) {
+        std::size_t received;
+        sf::IpAddress sender;
+        unsigned short senderPort;
+        if (socket.receive(&receiveBuffer[0], receiveBuffer.size(), received, sender, senderPort) != sf::Socket::Done)
+            return false;
+        // anything else on this port is not ours
+        if (sender != peerAddress || senderPort != config.peerPort)
+            continue;
+        packet.assign(receiveBuffer.begin(), receiveBuffer.begin() + received);
+        return true;
+    }
+}
+
+void NetLink::flush()
+{
+    Clock::time_point now = Clock::now();
+    int kept = 0;
+    for (int i = 0; i < (int)delayed.size(); i += 1) {
+        if (delayed[i].sendTime <= now) {
+            sendNow(delayed[i].packet);
+        } else {
+            std::swap(delayed[kept], delayed[i]);
+            kept += 1;
+        }
+    }
+    delayed.resize(kept);
+}
+
+void NetLink::sendNow(const std::vector<unsigned char> &packet)
+{
+    // a full send buffer is just more loss as far as rollback cares
+    socket.send(&packet[0], packet.size(), peerAddress, config.peerPort);
+}
+
+// xorshift32, so the shim drops the same packets every run of a seed
+float NetLink::nextShimFloat()
+{
+    shimState ^= shimState << 13;
+    shimState ^= shimState >> 17;
+    shimState ^= shimState << 5;
+    return (shimState & 0xffffff) / (float)0x1000000;
+}
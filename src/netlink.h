@@ -0,0 +1,58 @@
+#ifndef NETLINK_H
+#define NETLINK_H
+
+#include <SFML/Network.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// How to reach the other peer of an online match, and how bad to pretend
+// the network between us is.
+struct NetConfig {
+    unsigned short port = 7000;
+    std::string peerHost = "127.0.0.1";
+    unsigned short peerPort = 7001;
+    // 0 or 1; picks which players are ours
+    int side = 0;
+    // added to every packet we send, on top of the real network
+    int latencyMs = 0;
+    int jitterMs = 0;
+    float loss = 0.0f;
+    unsigned int shimSeed = 1;
+};
+
+// Unreliable datagrams to and from one peer. Outgoing packets go through a
+// shim that can delay, reorder and drop them, so rollback can be tested on
+// one machine.
+class NetLink
+{
+public:
+    NetLink(const NetConfig &config);
+
+    void send(const std::vector<unsigned char> &packet);
+    // Hands over the next packet from the peer, if there is one.
+    bool receive(std::vector<unsigned char> &packet);
+    // sends whatever the shim has held for long enough
+    void flush();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Delayed {
+        Clock::time_point sendTime;
+        std::vector<unsigned char> packet;
+    };
+
+    NetConfig config;
+    sf::UdpSocket socket;
+    sf::IpAddress peerAddress;
+    std::vector<Delayed> delayed;
+    unsigned int shimState;
+    std::vector<unsigned char> receiveBuffer;
+
+    void sendNow(const std::vector<unsigned char> &packet);
+    float nextShimFloat();
+};
+
+#endif // NETLINK_H
@@ -0,0 +1,176 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+// plenty for a few minutes of frames, and bounded so a forgotten --trace
+// cannot eat all the memory
+static const size_t maxTraceEvents = 1 << 22;
+
+struct TraceEvent {
+    const char *name;
+    int tid;
+    long long start;
+    long long end;
+};
+
+struct ZoneAccum {
+    const char *name;
+    long long frameNs;
+    long long windowNs;
+    long long windowMaxNs;
+};
+
+static std::atomic<bool> enabled(false);
+static std::mutex mutex;
+static bool tracing = false;
+static std::vector<TraceEvent> traceEvents;
+static std::vector<ZoneAccum> accums;
+static std::vector<Profiler::ZoneStats> stats;
+static int windowFrames = 0;
+static int version = 0;
+static std::atomic<int> nextThreadId(0);
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+static long long nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+static int threadId() {
+    static thread_local int id = nextThreadId++;
+    return id;
+}
+
+Profiler::Zone::Zone(const char *name) :
+    name(name),
+    start(enabled.load(std::memory_order_relaxed) ? nowNs() : -1)
+{
+}
+
+Profiler::Zone::~Zone()
+{
+    if (start >= 0)
+        Profiler::record(name, start, nowNs());
+}
+
+void Profiler::setEnabled(bool value)
+{
+    enabled = value;
+}
+
+bool Profiler::isEnabled()
+{
+    return enabled;
+}
+
+void Profiler::startTrace()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    tracing = true;
+    traceEvents.clear();
+}
+
+bool Profiler::isTracing()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tracing;
+}
+
+void Profiler::record(const char *name, long long start, long long end)
+{
+    int tid = threadId();
+    std::lock_guard<std::mutex> lock(mutex);
+
+    ZoneAccum *accum = NULL;
+    for (int i = 0; i < (int)accums.size(); i += 1) {
+        if (accums[i].name == name) {
+            accum = &accums[i];
+            break;
+        }
+    }
+    if (!accum) {
+        ZoneAccum newAccum = {name, 0, 0, 0};
+        accums.push_back(newAccum);
+        accum = &accums.back();
+    }
+    accum->frameNs += end - start;
+
+    if (tracing) {
+        if (traceEvents.size() < maxTraceEvents) {
+            TraceEvent event = {name, tid, start, end};
+            traceEvents.push_back(event);
+        } else {
+            std::cerr << "Trace buffer full, no longer tracing\n";
+            tracing = false;
+        }
+    }
+}
+
+void Profiler::endFrame()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < (int)accums.size(); i += 1) {
+        ZoneAccum &accum = accums[i];
+        accum.windowNs += accum.frameNs;
+        accum.windowMaxNs = std::max(accum.windowMaxNs, accum.frameNs);
+        accum.frameNs = 0;
+    }
+
+    windowFrames += 1;
+    if (windowFrames < statsWindow)
+        return;
+
+    stats.clear();
+    for (int i = 0; i < (int)accums.size(); i += 1) {
+        ZoneAccum &accum = accums[i];
+        ZoneStats zoneStats;
+        zoneStats.name = accum.name;
+        zoneStats.avgMs = accum.windowNs / (double)statsWindow / 1000000.0;
+        zoneStats.maxMs = accum.windowMaxNs / 1000000.0;
+        stats.push_back(zoneStats);
+        accum.windowNs = 0;
+        accum.windowMaxNs = 0;
+    }
+    windowFrames = 0;
+    version += 1;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::getStats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+int Profiler::statsVersion()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return version;
+}
+
+bool Profiler::writeTrace(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ofstream out(path.c_str());
+    if (!out) {
+        std::cerr << "Unable to write trace: " << path << "\n";
+        return false;
+    }
+
+    // chrome trace_event format, complete events with microsecond times
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < traceEvents.size(); i += 1) {
+        const TraceEvent &event = traceEvents[i];
+        out << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.tid <<
+               ",\"ts\":" << (event.start / 1000.0) << ",\"dur\":" << ((event.end - event.start) / 1000.0) << "}";
+        out << ((i + 1 < traceEvents.size()) ? ",\n" : "\n");
+    }
+    out << "]}\n";
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <vector>
+
+// Scoped timing zones, summarized per zone for the overlay and optionally
+// kept as a chrome://tracing trace. Zone names must be string literals;
+// they are stored by pointer. Zones cost almost nothing while disabled.
+class Profiler
+{
+public:
+    class Zone {
+    public:
+        Zone(const char *name);
+        ~Zone();
+    private:
+        const char *name;
+        long long start;
+    };
+
+    struct ZoneStats {
+        const char *name;
+        double avgMs;
+        double maxMs;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static void startTrace();
+    static bool isTracing();
+    static bool writeTrace(const std::string &path);
+
+    // call once per frame, outside of any zone
+    static void endFrame();
+
+    // refreshed once every statsWindow frames; statsVersion changes when
+    // that happens
+    static std::vector<ZoneStats> getStats();
+    static int statsVersion();
+    static const int statsWindow = 60;
+
+private:
+    static void record(const char *name, long long start, long long end);
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,59 @@
+#include "rendersnapshot.h"
+
+void RenderSnapshot::capture(const World &world, std::chrono::steady_clock::time_point time)
+{
+    stepIndex = world.stepIndex;
+    timeStep = world.timeStep;
+    stepTime = time;
+
+    const World::PlayerState &state = world.playerState;
+    players.resize(world.players.size());
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        const World::Player *worldPlayer = world.players[i];
+        Player &player = players[i];
+        player.prevPos = worldPlayer->prevPos;
+        player.pos = worldPlayer->body->p;
+        player.vel = worldPlayer->body->v;
+        player.angle = worldPlayer->body->a;
+        player.facing = state.facing[i];
+        player.pointAngle = state.pointAngle[i];
+        player.footContacts = state.footContacts[i];
+        player.clawState = state.clawState[i];
+        player.prevAimStartPos = worldPlayer->prevAimStartPos;
+        player.aimStartPos = state.aimStartPos[i];
+        player.xAxis = state.input[i].xAxis;
+
+        if (player.clawState != World::ClawStateRetracted) {
+            player.prevClawPos = worldPlayer->prevClawPos;
+            player.clawPos = worldPlayer->clawBody->p;
+            player.clawAngle = worldPlayer->clawBody->a;
+            player.jnAcc = worldPlayer->slideJoint->jnAcc;
+        }
+    }
+}
+
+void MapLayout::capture(const World &world)
+{
+    arenaWidth = world.arenaWidth;
+    arenaHeight = world.arenaHeight;
+    tileWidth = world.tileWidth;
+    tileHeight = world.tileHeight;
+
+    platforms.clear();
+    for (int i = 0; i < (int)world.platforms.size(); i += 1) {
+        const World::Platform *worldPlatform = world.platforms[i];
+        if (!worldPlatform->image)
+            continue;
+        Platform platform;
+        platform.image = worldPlatform->image;
+        platform.pos = worldPlatform->pos;
+        platform.size = worldPlatform->size;
+        platforms.push_back(platform);
+    }
+
+    tileLayers.clear();
+    for (int i = 0; i < (int)world.tileLayers.size(); i += 1) {
+        if (world.tileLayers[i]->visible)
+            tileLayers.push_back(*world.tileLayers[i]);
+    }
+}
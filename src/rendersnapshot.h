@@ -0,0 +1,64 @@
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include <chrono>
+#include <vector>
+
+#include "world.h"
+
+// Everything the renderer needs from one simulation step, copied out of the
+// world so drawing never touches it while the simulation thread runs.
+struct RenderSnapshot {
+    struct Player {
+        cpVect prevPos;
+        cpVect pos;
+        cpVect vel;
+        float angle;
+        float facing;
+        float pointAngle;
+        int footContacts;
+        World::ClawState clawState;
+        cpVect prevClawPos;
+        cpVect clawPos;
+        float clawAngle;
+        cpVect prevAimStartPos;
+        cpVect aimStartPos;
+
+        // for the debug text
+        float xAxis;
+        float jnAcc;
+    };
+
+    int stepIndex = 0;
+    float timeStep = 0.0f;
+    // when the step was due; drawing interpolates from prev* towards the
+    // current values over the following time step
+    std::chrono::steady_clock::time_point stepTime;
+    std::vector<Player> players;
+
+    // Does not allocate once players has the world's player count.
+    void capture(const World &world, std::chrono::steady_clock::time_point time);
+};
+
+// The map's geometry, which never changes once it is loaded. It is copied
+// out at load so the renderer can bake it without touching the world.
+struct MapLayout {
+    struct Platform {
+        RuckSackImage *image;
+        cpVect pos;
+        cpVect size;
+    };
+
+    float arenaWidth = 0.0f;
+    float arenaHeight = 0.0f;
+    float tileWidth = 0.0f;
+    float tileHeight = 0.0f;
+    // only those with an image
+    std::vector<Platform> platforms;
+    // only the visible ones
+    std::vector<World::TileLayer> tileLayers;
+
+    void capture(const World &world);
+};
+
+#endif // RENDERSNAPSHOT_H
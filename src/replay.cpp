@@ -0,0 +1,214 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+static const char replayMagic[4] = {'G', 'R', 'P', 'L'};
+// 2 added the world state size
+static const unsigned int replayVersion = 2;
+
+enum {
+    ButtonJump = 1 << 0,
+    ButtonFireGrapple = 1 << 1,
+    ButtonUnhookGrapple = 1 << 2,
+    ButtonReelOut = 1 << 3,
+};
+
+static signed char quantizeAxis(float value) {
+    value = std::max(-1.0f, std::min(1.0f, value));
+    return (signed char)lroundf(value * 127.0f);
+}
+
+static void writeU32(std::ofstream &out, unsigned int value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static unsigned int readU32(std::ifstream &in) {
+    unsigned int value = 0;
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return value;
+}
+
+Replay::Replay() :
+    playerCount(0),
+    keyframeInterval(300)
+{
+}
+
+void Replay::packInput(const PlayerInput &input, unsigned char *out)
+{
+    out[0] = (unsigned char)quantizeAxis(input.xAxis);
+    out[1] = (unsigned char)quantizeAxis(input.yAxis);
+    out[2] = (input.btnJump ? ButtonJump : 0) |
+            (input.btnFireGrapple ? ButtonFireGrapple : 0) |
+            (input.btnUnhookGrapple ? ButtonUnhookGrapple : 0) |
+            (input.btnReelOut ? ButtonReelOut : 0);
+}
+
+void Replay::unpackInput(const unsigned char *in, PlayerInput &input)
+{
+    input.xAxis = (signed char)in[0] / 127.0f;
+    input.yAxis = (signed char)in[1] / 127.0f;
+    input.btnJump = !!(in[2] & ButtonJump);
+    input.btnFireGrapple = !!(in[2] & ButtonFireGrapple);
+    input.btnUnhookGrapple = !!(in[2] & ButtonUnhookGrapple);
+    input.btnReelOut = !!(in[2] & ButtonReelOut);
+}
+
+int Replay::stepCount() const
+{
+    if (playerCount == 0)
+        return 0;
+    return inputs.size() / (playerCount * bytesPerInput);
+}
+
+void Replay::recordStep(World *world)
+{
+    if (playerCount == 0) {
+        mapKey = world->mapKey;
+        playerCount = world->players.size();
+    }
+    int step = stepCount();
+    assert(world->stepIndex == step);
+
+    if (step % keyframeInterval == 0) {
+        keyframes.push_back(Keyframe());
+        Keyframe &keyframe = keyframes.back();
+        keyframe.step = step;
+        world->saveState(keyframe.state);
+    }
+
+    for (int i = 0; i < playerCount; i += 1) {
+        unsigned char packed[bytesPerInput];
+        packInput(world->playerState.input[i], packed);
+        unpackInput(packed, world->playerState.input[i]);
+        inputs.insert(inputs.end(), packed, packed + bytesPerInput);
+    }
+}
+
+bool Replay::playStep(World *world)
+{
+    checkWorld(world);
+    int step = world->stepIndex;
+    if (step >= stepCount())
+        return false;
+
+    for (int i = 0; i < playerCount; i += 1) {
+        unpackInput(&inputs[(step * playerCount + i) * bytesPerInput], world->playerState.input[i]);
+    }
+    return true;
+}
+
+void Replay::seek(World *world, int step)
+{
+    checkWorld(world);
+    step = std::max(0, std::min(step, stepCount()));
+    const Keyframe *keyframe = findKeyframe(step);
+    // stepping on from the live world stays exact, so only restore a
+    // keyframe when there is no other way back or it saves work
+    if (keyframe && (world->stepIndex > step || keyframe->step > world->stepIndex))
+        world->loadState(keyframe->state);
+    while (world->stepIndex < step && playStep(world)) {
+        world->step();
+    }
+}
+
+void Replay::checkWorld(const World *world) const
+{
+    if (playerCount != (int)world->players.size()) {
+        std::cerr << "Replay has " << playerCount << " players but map " << world->mapKey
+                  << " has " << world->players.size() << "\n";
+        std::exit(1);
+    }
+}
+
+const Replay::Keyframe *Replay::findKeyframe(int step)
+{
+    // keyframes are in step order
+    const Keyframe *found = NULL;
+    for (int i = 0; i < (int)keyframes.size() && keyframes[i].step <= step; i += 1) {
+        found = &keyframes[i];
+    }
+    return found;
+}
+
+void Replay::save(const std::string &path)
+{
+    std::ofstream out(path.c_str(), std::ios::binary);
+    if (!out) {
+        std::cerr << "Unable to write replay: " << path << "\n";
+        std::exit(1);
+    }
+
+    out.write(replayMagic, sizeof(replayMagic));
+    writeU32(out, replayVersion);
+    writeU32(out, mapKey.size());
+    out.write(mapKey.data(), mapKey.size());
+    writeU32(out, playerCount);
+    writeU32(out, World::stateSize(playerCount));
+    writeU32(out, keyframeInterval);
+    writeU32(out, inputs.size());
+    out.write(reinterpret_cast<const char *>(inputs.data()), inputs.size());
+    writeU32(out, keyframes.size());
+    for (int i = 0; i < (int)keyframes.size(); i += 1) {
+        const Keyframe &keyframe = keyframes[i];
+        writeU32(out, keyframe.step);
+        writeU32(out, keyframe.state.size());
+        out.write(reinterpret_cast<const char *>(keyframe.state.data()), keyframe.state.size());
+    }
+}
+
+void Replay::load(const std::string &path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        std::cerr << "Unable to open replay: " << path << "\n";
+        std::exit(1);
+    }
+
+    char magic[sizeof(replayMagic)];
+    in.read(magic, sizeof(magic));
+    if (!in || !std::equal(magic, magic + sizeof(magic), replayMagic)) {
+        std::cerr << path << " is not a replay\n";
+        std::exit(1);
+    }
+    // keyframes are raw world state, so only the same build can read them
+    if (readU32(in) != replayVersion) {
+        std::cerr << path << ": unsupported replay version\n";
+        std::exit(1);
+    }
+
+    mapKey.resize(readU32(in));
+    in.read(&mapKey[0], mapKey.size());
+    playerCount = readU32(in);
+    // the layout can change without the version, whenever World does
+    size_t stateSize = readU32(in);
+    if (in && stateSize != World::stateSize(playerCount)) {
+        std::cerr << path << ": recorded by a build that saves the world differently\n";
+        std::exit(1);
+    }
+    keyframeInterval = readU32(in);
+    inputs.resize(readU32(in));
+    in.read(reinterpret_cast<char *>(inputs.data()), inputs.size());
+    keyframes.resize(readU32(in));
+    for (int i = 0; i < (int)keyframes.size(); i += 1) {
+        Keyframe &keyframe = keyframes[i];
+        keyframe.step = readU32(in);
+        unsigned int size = readU32(in);
+        if (in && size != stateSize) {
+            std::cerr << path << ": keyframe " << i << " is " << size << " bytes, expected " << stateSize << "\n";
+            std::exit(1);
+        }
+        keyframe.state.resize(size);
+        in.read(reinterpret_cast<char *>(keyframe.state.data()), keyframe.state.size());
+    }
+
+    if (!in || keyframeInterval <= 0) {
+        std::cerr << path << ": replay is truncated or corrupt\n";
+        std::exit(1);
+    }
+}
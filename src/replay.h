@@ -0,0 +1,63 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+
+#include "world.h"
+
+// A recorded match: every player's input for every step, plus a full world
+// state every keyframeInterval steps so playback can seek without
+// simulating from the start.
+//
+// Recording only saves keyframes and straight playback never loads them, so
+// both match an unrecorded game step for step. A keyframe does not hold
+// chipmunk's cached contacts, so playback after a seek to one can drift from
+// the recording.
+//
+// Axes are stored quantized to a signed byte. The recorder applies the
+// quantized values to the live world too, so playback reproduces the
+// recording exactly.
+class Replay
+{
+public:
+    Replay();
+
+    std::string mapKey;
+    int playerCount;
+    int keyframeInterval;
+
+    // Call once per step, before World::step(), with the step's input
+    // already set on the players.
+    void recordStep(World *world);
+
+    int stepCount() const;
+    // Sets the players' input for the world's next step. Returns false when
+    // the replay has run out. Like seek, exits if the world has a different
+    // number of players than the replay.
+    bool playStep(World *world);
+    // Simulates forward to step, first restoring the nearest keyframe at or
+    // before it if that is closer or the world is already past step.
+    void seek(World *world, int step);
+
+    void save(const std::string &path);
+    void load(const std::string &path);
+
+private:
+    struct Keyframe {
+        int step;
+        std::vector<unsigned char> state;
+    };
+
+    static const int bytesPerInput = 3;
+
+    std::vector<unsigned char> inputs;
+    std::vector<Keyframe> keyframes;
+
+    void packInput(const PlayerInput &input, unsigned char *out);
+    void unpackInput(const unsigned char *in, PlayerInput &input);
+    void checkWorld(const World *world) const;
+    const Keyframe *findKeyframe(int step);
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,134 @@
+#include "resourcebundle.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <map>
+
+ResourceBundle::ResourceBundle() :
+    bundle(NULL),
+    spritesheet(NULL),
+    imagesById()
+{
+}
+
+ResourceBundle::~ResourceBundle()
+{
+    if (spritesheet)
+        rucksack_texture_close(spritesheet);
+    if (bundle)
+        rucksack_bundle_close(bundle);
+}
+
+void ResourceBundle::open(const std::string &path)
+{
+    this->path = path;
+    int err = rucksack_bundle_open_read(path.c_str(), &bundle);
+    if (err != RuckSackErrorNone) {
+        std::cerr << "Error opening rucksack bundle: " << rucksack_err_str(err) << "\n";
+        std::exit(1);
+    }
+
+    RuckSackFileEntry *entry = findFile(bundle, "spritesheet");
+    err = rucksack_file_open_texture(entry, &spritesheet);
+    if (err) {
+        std::cerr << "Error reading 'spritesheet' as texture: " << rucksack_err_str(err) << "\n";
+        std::exit(1);
+    }
+
+    images.resize(rucksack_texture_image_count(spritesheet));
+    rucksack_texture_get_images(spritesheet, &images[0]);
+    std::map<std::string, RuckSackImage *> imageMap;
+    for (int i = 0; i < (int)images.size(); i += 1) {
+        RuckSackImage *image = images[i];
+        imageMap[std::string(image->key, image->key_size)] = image;
+    }
+
+    // ImageIds come from assets.json, so this only fails when the bundle is
+    // older than the build
+    for (int i = 0; i < ImageIdCount; i += 1) {
+        std::map<std::string, RuckSackImage *>::iterator it = imageMap.find(imageKeys[i]);
+        if (it == imageMap.end()) {
+            std::cerr << "Missing image: " << imageKeys[i] << "\n";
+            std::exit(1);
+        }
+        imagesById[i] = it->second;
+    }
+}
+
+RuckSackBundle *ResourceBundle::openReader()
+{
+    RuckSackBundle *reader;
+    int err = rucksack_bundle_open_read(path.c_str(), &reader);
+    if (err != RuckSackErrorNone) {
+        std::cerr << "Error opening rucksack bundle: " << rucksack_err_str(err) << "\n";
+        std::exit(1);
+    }
+    return reader;
+}
+
+RuckSackFileEntry *ResourceBundle::findFile(RuckSackBundle *bundle, const std::string &key)
+{
+    RuckSackFileEntry *entry = rucksack_bundle_find_file(bundle, key.c_str(), key.size());
+    if (!entry) {
+        std::cerr << "Could not find resource '" << key << "' in bundle.\n";
+        std::exit(1);
+    }
+    return entry;
+}
+
+std::string ResourceBundle::getString(const std::string &key)
+{
+    RuckSackBundle *reader = openReader();
+    RuckSackFileEntry *entry = findFile(reader, key);
+
+    long size = rucksack_file_size(entry);
+    std::string contents;
+    contents.resize(size);
+    int err = rucksack_file_read(entry, reinterpret_cast<unsigned char *>(&contents[0]));
+    rucksack_bundle_close(reader);
+
+    if (err) {
+        std::cerr << "Error reading '" << key << "' resource: " << rucksack_err_str(err) << "\n";
+        std::exit(1);
+    }
+
+    return contents;
+}
+
+void ResourceBundle::readFile(const std::string &key, std::vector<unsigned char> &buffer)
+{
+    RuckSackBundle *reader = openReader();
+    RuckSackFileEntry *entry = findFile(reader, key);
+
+    buffer.resize(rucksack_file_size(entry));
+    int err = rucksack_file_read(entry, &buffer[0]);
+    rucksack_bundle_close(reader);
+
+    if (err) {
+        std::cerr << "Error reading '" << key << "' resource: " << rucksack_err_str(err) << "\n";
+        std::exit(1);
+    }
+}
+
+void ResourceBundle::readSpritesheet(std::vector<unsigned char> &buffer)
+{
+    RuckSackBundle *reader = openReader();
+    RuckSackTexture *texture;
+    int err = rucksack_file_open_texture(findFile(reader, "spritesheet"), &texture);
+    if (!err) {
+        buffer.resize(rucksack_texture_size(texture));
+        err = rucksack_texture_read(texture, &buffer[0]);
+        rucksack_texture_close(texture);
+    }
+    rucksack_bundle_close(reader);
+
+    if (err) {
+        std::cerr << "Error reading 'spritesheet' texture: " << rucksack_err_str(err) << "\n";
+        std::exit(1);
+    }
+}
+
+RuckSackImage *ResourceBundle::getImage(ImageId id)
+{
+    return imagesById[id];
+}
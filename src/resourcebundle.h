@@ -0,0 +1,42 @@
+#ifndef RESOURCEBUNDLE_H
+#define RESOURCEBUNDLE_H
+
+#include <rucksack.h>
+
+#include <string>
+#include <vector>
+
+#include "assetids.h"
+
+// Wraps the rucksack bundle. Nothing in here touches OpenGL, so it is safe
+// to use from the headless runner on machines with no display. Once open,
+// it can be read from several threads at once.
+class ResourceBundle
+{
+public:
+    ResourceBundle();
+    ~ResourceBundle();
+
+    void open(const std::string &path);
+
+    std::string getString(const std::string &key);
+    void readFile(const std::string &key, std::vector<unsigned char> &buffer);
+
+    // encoded image data of the spritesheet texture
+    void readSpritesheet(std::vector<unsigned char> &buffer);
+    RuckSackImage *getImage(ImageId id);
+
+private:
+    std::string path;
+    RuckSackBundle *bundle;
+    RuckSackTexture *spritesheet;
+    std::vector<RuckSackImage *> images;
+    RuckSackImage *imagesById[ImageIdCount];
+
+    // rucksack reads every file through its bundle's one file handle, so
+    // each read opens a bundle of its own and reads on other threads overlap
+    RuckSackBundle *openReader();
+    RuckSackFileEntry *findFile(RuckSackBundle *bundle, const std::string &key);
+};
+
+#endif // RESOURCEBUNDLE_H
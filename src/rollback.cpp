@@ -0,0 +1,384 @@
+#include "rollback.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+// how many steps we guess ahead of the peer's input before waiting for it
+static int maxPrediction = 8;
+// must hold every step from the newest confirmed one to the newest input
+// the peer can have sent
+static int historySize = 64;
+// input for at most this many steps goes in one packet
+static int maxStepsPerPacket = 32;
+static int helloIntervalMs = 100;
+static int connectTimeoutMs = 60 * 1000;
+// time sync: how quickly the measured advantage follows each new step, and
+// how much the side that is ahead slows down per step it is ahead
+static float advantageSmoothing = 0.05f;
+static float slowdownPerStep = 0.02f;
+static float maxSlowdown = 0.1f;
+
+enum PacketType {
+    PacketHello,
+    PacketInput,
+};
+
+enum InputButton {
+    InputButtonJump = 1,
+    InputButtonFireGrapple = 2,
+    InputButtonUnhookGrapple = 4,
+    InputButtonReelOut = 8,
+};
+
+template <typename T>
+static void writePacket(std::vector<unsigned char> &packet, const T &value)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+    packet.insert(packet.end(), bytes, bytes + sizeof(T));
+}
+
+// Packets come off the network, so unlike saved state they are checked.
+template <typename T>
+static bool readPacket(const std::vector<unsigned char> &packet, size_t &offset, T &value)
+{
+    if (offset + sizeof(T) > packet.size())
+        return false;
+    memcpy(&value, &packet[offset], sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+static bool sameInput(const PlayerInput &a, const PlayerInput &b)
+{
+    return a.xAxis == b.xAxis && a.yAxis == b.yAxis && a.btnJump == b.btnJump &&
+           a.btnFireGrapple == b.btnFireGrapple && a.btnUnhookGrapple == b.btnUnhookGrapple &&
+           a.btnReelOut == b.btnReelOut;
+}
+
+RollbackSession::RollbackSession(World *world, ResourceBundle *bundle, const NetConfig &config) :
+    checksums(NULL),
+    rollbacks(0),
+    resimulatedSteps(0),
+    stalls(0),
+    world(world),
+    predicted(new World(bundle, world->tuning)),
+    predicting(false),
+    link(config),
+    side(config.side),
+    playerCount(world->players.size()),
+    heardPeer(false),
+    peerHeardUs(false),
+    inputs(historySize * world->players.size()),
+    localNext(0),
+    remoteNext(0),
+    peerAck(0),
+    rollbackStep(-1),
+    advantage(0.0f),
+    peerAdvantage(0.0f)
+{
+    predicted->loadMap(world->mapKey);
+
+    // sides take turns, so each gets half the players and the map's
+    // starts stay spread between them
+    isLocal.resize(playerCount, false);
+    for (int i = side; i < playerCount; i += 2) {
+        localPlayers.push_back(i);
+        isLocal[i] = true;
+    }
+}
+
+RollbackSession::~RollbackSession()
+{
+    delete predicted;
+}
+
+void RollbackSession::connect()
+{
+    std::chrono::steady_clock::time_point giveUp = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(connectTimeoutMs);
+    while (!peerHeardUs) {
+        if (std::chrono::steady_clock::now() > giveUp) {
+            std::cerr << "no answer from peer\n";
+            std::exit(1);
+        }
+        sendHello();
+        std::this_thread::sleep_for(std::chrono::milliseconds(helloIntervalMs));
+        receivePackets();
+    }
+    // the peer may still be waiting to hear that we heard it
+    sendHello();
+}
+
+const std::vector<int> &RollbackSession::getLocalPlayers() const
+{
+    return localPlayers;
+}
+
+bool RollbackSession::advance(const std::vector<PlayerInput> &localInput)
+{
+    receivePackets();
+    int step = localNext;
+    if (step - remoteNext >= maxPrediction) {
+        // the peer may be waiting on us just the same, for a lost packet
+        stalls += 1;
+        poll();
+        return false;
+    }
+
+    for (int i = 0; i < (int)localPlayers.size(); i += 1) {
+        PlayerInput &input = inputAt(step, localPlayers[i]);
+        if (i < (int)localInput.size())
+            input = localInput[i];
+        else
+            input.reset();
+    }
+    localNext = step + 1;
+    // smoothed, so one late packet does not jolt the pacing
+    advantage += ((localNext - remoteNext) - advantage) * advantageSmoothing;
+    sendInput();
+    confirm();
+    predict();
+    return true;
+}
+
+void RollbackSession::poll()
+{
+    receivePackets();
+    if (localNext > peerAck)
+        sendInput();
+    link.flush();
+    confirm();
+    predict();
+}
+
+const World *RollbackSession::getWorld() const
+{
+    return predicting ? predicted : world;
+}
+
+int RollbackSession::getLocalStep() const
+{
+    return localNext;
+}
+
+int RollbackSession::getConfirmedStep() const
+{
+    return world->stepIndex;
+}
+
+int RollbackSession::getPeerAckedStep() const
+{
+    return peerAck;
+}
+
+float RollbackSession::getStepScale() const
+{
+    // Each side's advantage counts the latency as well as the lead, so
+    // half the difference is the lead alone.
+    float ahead = (advantage - peerAdvantage) / 2.0f;
+    if (ahead <= 0.0f)
+        return 1.0f;
+    return 1.0f + std::min(ahead * slowdownPerStep, maxSlowdown);
+}
+
+PlayerInput &RollbackSession::inputAt(int step, int player)
+{
+    return inputs[(step % historySize) * playerCount + player];
+}
+
+// Takes every step both sides have input for.
+void RollbackSession::confirm()
+{
+    int end = std::min(localNext, remoteNext);
+    while (world->stepIndex < end) {
+        int step = world->stepIndex;
+        for (int i = 0; i < playerCount; i += 1) {
+            world->playerState.input[i] = inputAt(step, i);
+        }
+        world->step();
+        if (checksums)
+            checksums->record(*world);
+    }
+}
+
+// Brings the predicted world up to our latest input, starting it over from
+// the confirmed world if it is new or a guess it made was wrong.
+void RollbackSession::predict()
+{
+    if (world->stepIndex == localNext) {
+        // nothing is guessed, so show the real thing
+        predicting = false;
+        rollbackStep = -1;
+        return;
+    }
+    if (!predicting || rollbackStep >= 0) {
+        Profiler::Zone zone("rollback");
+        if (predicting) {
+            rollbacks += 1;
+            resimulatedSteps += predicted->stepIndex - world->stepIndex;
+        }
+        world->saveState(state);
+        predicted->loadState(state);
+        predicting = true;
+        rollbackStep = -1;
+    }
+    while (predicted->stepIndex < localNext) {
+        stepPredicted();
+    }
+}
+
+void RollbackSession::stepPredicted()
+{
+    int step = predicted->stepIndex;
+    for (int i = 0; i < playerCount; i += 1) {
+        // a guess is the last input we really have, and is kept so it can
+        // be checked when the real one arrives
+        if (!isLocal[i] && step >= remoteNext) {
+            if (remoteNext > 0)
+                inputAt(step, i) = inputAt(remoteNext - 1, i);
+            else
+                inputAt(step, i).reset();
+        }
+        predicted->playerState.input[i] = inputAt(step, i);
+    }
+    predicted->step();
+}
+
+void RollbackSession::sendHello()
+{
+    packet.clear();
+    writePacket(packet, (unsigned char)PacketHello);
+    writePacket(packet, (unsigned char)side);
+    writePacket(packet, (unsigned char)heardPeer);
+    writePacket(packet, (unsigned char)playerCount);
+    writePacket(packet, (unsigned char)world->mapKey.size());
+    packet.insert(packet.end(), world->mapKey.begin(), world->mapKey.end());
+    link.send(packet);
+}
+
+// Our input from the first step the peer has not acknowledged, so a lost
+// packet is covered by the next one.
+void RollbackSession::sendInput()
+{
+    int end = localNext;
+    int start = std::max(peerAck, end - maxStepsPerPacket);
+
+    packet.clear();
+    writePacket(packet, (unsigned char)PacketInput);
+    writePacket(packet, (unsigned char)side);
+    writePacket(packet, remoteNext);
+    writePacket(packet, advantage);
+    writePacket(packet, start);
+    writePacket(packet, end - start);
+    for (int step = start; step < end; step += 1) {
+        for (int i = 0; i < (int)localPlayers.size(); i += 1) {
+            const PlayerInput &input = inputAt(step, localPlayers[i]);
+            unsigned char buttons = (input.btnJump ? InputButtonJump : 0) |
+                                    (input.btnFireGrapple ? InputButtonFireGrapple : 0) |
+                                    (input.btnUnhookGrapple ? InputButtonUnhookGrapple : 0) |
+                                    (input.btnReelOut ? InputButtonReelOut : 0);
+            writePacket(packet, input.xAxis);
+            writePacket(packet, input.yAxis);
+            writePacket(packet, buttons);
+        }
+    }
+    link.send(packet);
+}
+
+void RollbackSession::receivePackets()
+{
+    while (link.receive(received)) {
+        unsigned char type;
+        size_t offset = 0;
+        if (!readPacket(received, offset, type))
+            continue;
+        if (type == PacketHello)
+            readHello(received);
+        else if (type == PacketInput)
+            readInput(received);
+    }
+}
+
+void RollbackSession::readHello(const std::vector<unsigned char> &packet)
+{
+    size_t offset = 1;
+    unsigned char peerSide, heard, peerPlayerCount, keySize;
+    if (!readPacket(packet, offset, peerSide) || !readPacket(packet, offset, heard) ||
+        !readPacket(packet, offset, peerPlayerCount) || !readPacket(packet, offset, keySize) ||
+        offset + keySize > packet.size())
+    {
+        return;
+    }
+    std::string peerMapKey(packet.begin() + offset, packet.begin() + offset + keySize);
+    if (peerSide == side) {
+        std::cerr << "both peers are side " << side << "\n";
+        std::exit(1);
+    }
+    if (peerMapKey != world->mapKey || peerPlayerCount != playerCount) {
+        std::cerr << "peer is playing " << peerMapKey << ", not " << world->mapKey << "\n";
+        std::exit(1);
+    }
+    heardPeer = true;
+    if (heard)
+        peerHeardUs = true;
+}
+
+void RollbackSession::readInput(const std::vector<unsigned char> &packet)
+{
+    size_t offset = 1;
+    unsigned char peerSide;
+    int ack, start, count;
+    float sentAdvantage;
+    if (!readPacket(packet, offset, peerSide) || !readPacket(packet, offset, ack) ||
+        !readPacket(packet, offset, sentAdvantage) || !readPacket(packet, offset, start) ||
+        !readPacket(packet, offset, count))
+    {
+        return;
+    }
+    // input can only come from a peer that heard us
+    heardPeer = true;
+    peerHeardUs = true;
+    peerAck = std::max(peerAck, ack);
+    peerAdvantage = sentAdvantage;
+
+    for (int step = start; step < start + count; step += 1) {
+        if (step > remoteNext || step - world->stepIndex >= historySize - maxPrediction)
+            break;
+        for (int i = 0; i < playerCount; i += 1) {
+            if (isLocal[i])
+                continue;
+            PlayerInput input;
+            float xAxis, yAxis;
+            unsigned char buttons;
+            if (!readPacket(packet, offset, xAxis) || !readPacket(packet, offset, yAxis) ||
+                !readPacket(packet, offset, buttons))
+            {
+                return;
+            }
+            if (step < remoteNext)
+                continue;
+            input.xAxis = xAxis;
+            input.yAxis = yAxis;
+            input.btnJump = !!(buttons & InputButtonJump);
+            input.btnFireGrapple = !!(buttons & InputButtonFireGrapple);
+            input.btnUnhookGrapple = !!(buttons & InputButtonUnhookGrapple);
+            input.btnReelOut = !!(buttons & InputButtonReelOut);
+
+            // only a guess the predicted world has used can be wrong
+            PlayerInput &stored = inputAt(step, i);
+            if (predicting && step < predicted->stepIndex && !sameInput(stored, input) &&
+                (rollbackStep < 0 || step < rollbackStep))
+            {
+                rollbackStep = step;
+            }
+            stored = input;
+        }
+        if (step == remoteNext)
+            remoteNext += 1;
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include <string>
+#include <vector>
+
+#include "checksumlog.h"
+#include "netlink.h"
+#include "world.h"
+
+// GGPO style rollback between two peers. Each side steps as soon as it has
+// its own input, guessing that the other side's players still hold what
+// they last sent. When the real input turns out different, the guessed
+// steps are thrown away and simulated again.
+//
+// The world passed in only ever steps on real input from both sides and is
+// never restored, so it matches an offline game with the same input bit
+// for bit. The guessed steps run on a second world, copied from the first
+// after a wrong guess; that copy has no cached contacts, so what is shown
+// can be slightly off until the real input catches up.
+class RollbackSession
+{
+public:
+    // bundle is for the world the guessed steps run on
+    RollbackSession(World *world, ResourceBundle *bundle, const NetConfig &config);
+    ~RollbackSession();
+
+    // Waits for the peer to show up. Exits if it does not, or if it is
+    // playing a different map or the same side.
+    void connect();
+
+    // players driven from this side, in controller order
+    const std::vector<int> &getLocalPlayers() const;
+
+    // Takes input for the local players' next step and steps as far as it
+    // can, guessing the peer's input past what has arrived. Returns false
+    // without taking the input when it is too far ahead of the peer to keep
+    // guessing.
+    bool advance(const std::vector<PlayerInput> &localInput);
+    // Sends and receives without taking input, resending whatever input the
+    // peer has not acknowledged and stepping on whatever arrived.
+    void poll();
+
+    // the world as of the local players' latest input, guessed or not
+    const World *getWorld() const;
+    // the step advance() takes input for next
+    int getLocalStep() const;
+    // steps before this one have real input from both sides, and the world
+    // passed in has taken them
+    int getConfirmedStep() const;
+    // the peer has our input for steps before this one
+    int getPeerAckedStep() const;
+    // How much longer than usual to wait before the next step, 1 or a
+    // little more. The side running ahead of the other slows down until
+    // both guess about as far, so neither ends up waiting at maxPrediction.
+    float getStepScale() const;
+
+    // when set, gets the world's checksums after every confirmed step
+    ChecksumLog *checksums;
+
+    int rollbacks;
+    int resimulatedSteps;
+    int stalls;
+
+private:
+    World *world;
+    // runs ahead of world on guessed input
+    World *predicted;
+    // whether predicted is ahead of world and up to date with our input
+    bool predicting;
+    std::vector<unsigned char> state;
+    NetLink link;
+    int side;
+    std::vector<int> localPlayers;
+    std::vector<bool> isLocal;
+    int playerCount;
+    bool heardPeer;
+    bool peerHeardUs;
+
+    // indexed by step modulo its length
+    std::vector<PlayerInput> inputs;
+    // steps we have input for, ours and the peer's
+    int localNext;
+    int remoteNext;
+    int peerAck;
+    // earliest step whose guessed input was wrong, or -1
+    int rollbackStep;
+    // how many steps each side is ahead of the other's input, smoothed
+    float advantage;
+    float peerAdvantage;
+
+    std::vector<unsigned char> packet;
+    std::vector<unsigned char> received;
+
+    PlayerInput &inputAt(int step, int player);
+    void confirm();
+    void predict();
+    void stepPredicted();
+    void sendHello();
+    void sendInput();
+    void receivePackets();
+    void readHello(const std::vector<unsigned char> &packet);
+    void readInput(const std::vector<unsigned char> &packet);
+};
+
+#endif // ROLLBACK_H
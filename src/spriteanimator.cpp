@@ -0,0 +1,76 @@
+#include "spriteanimator.h"
+
+#include <cmath>
+#include <cstdlib>
+
+int SpriteAnimator::add(sf::Time frameTime)
+{
+    animations.push_back(NULL);
+    frameTimes.push_back(frameTime.asSeconds());
+    times.push_back(0.0f);
+    frames.push_back(0);
+    looped.push_back(true);
+    playing.push_back(false);
+    return animations.size() - 1;
+}
+
+void SpriteAnimator::clear()
+{
+    animations.clear();
+    frameTimes.clear();
+    times.clear();
+    frames.clear();
+    looped.clear();
+    playing.clear();
+}
+
+void SpriteAnimator::play(int sprite, const Animation &animation, bool looped)
+{
+    this->looped[sprite] = looped;
+    if (animations[sprite] == &animation)
+        return;
+    animations[sprite] = &animation;
+    times[sprite] = 0.0f;
+    frames[sprite] = 0;
+    playing[sprite] = true;
+}
+
+void SpriteAnimator::update(sf::Time deltaTime)
+{
+    float dt = deltaTime.asSeconds();
+    for (int i = 0; i < (int)times.size(); i += 1) {
+        if (!playing[i])
+            continue;
+
+        times[i] += dt;
+        if (times[i] < frameTimes[i])
+            continue;
+        // one frame per update, like a sprite that was stepped every frame;
+        // the remainder only needs a divide after a long hitch
+        times[i] -= frameTimes[i];
+        if (times[i] >= frameTimes[i])
+            times[i] = fmodf(times[i], frameTimes[i]);
+
+        if (frames[i] + 1 < (int)animations[i]->getSize())
+            frames[i] += 1;
+        else if (looped[i])
+            frames[i] = 0;
+        else
+            playing[i] = false;
+    }
+}
+
+const sf::Vertex *SpriteAnimator::getQuad(int sprite) const
+{
+    if (!animations[sprite])
+        return NULL;
+    return animations[sprite]->getQuad(frames[sprite]);
+}
+
+sf::FloatRect SpriteAnimator::getLocalBounds(int sprite) const
+{
+    if (!animations[sprite])
+        return sf::FloatRect();
+    const sf::IntRect &rect = animations[sprite]->getFrame(frames[sprite]);
+    return sf::FloatRect(0.0f, 0.0f, std::abs(rect.width), std::abs(rect.height));
+}
@@ -0,0 +1,37 @@
+#ifndef SPRITEANIMATOR_H
+#define SPRITEANIMATOR_H
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+#include "animation.h"
+
+// Plays animations for any number of sprites. A sprite is an index into
+// arrays that update() walks in a single pass, and its frames are the quads
+// Animation built up front, so nothing is recomputed when a frame changes.
+class SpriteAnimator
+{
+public:
+    // returns the new sprite's index
+    int add(sf::Time frameTime);
+    void clear();
+
+    // Restarts the sprite on animation unless it is already playing it.
+    void play(int sprite, const Animation &animation, bool looped);
+    void update(sf::Time deltaTime);
+
+    // the current frame in the sprite's local space, or NULL before play()
+    const sf::Vertex *getQuad(int sprite) const;
+    sf::FloatRect getLocalBounds(int sprite) const;
+
+private:
+    std::vector<const Animation *> animations;
+    std::vector<float> frameTimes;
+    std::vector<float> times;
+    std::vector<int> frames;
+    std::vector<bool> looped;
+    std::vector<bool> playing;
+};
+
+#endif // SPRITEANIMATOR_H
@@ -0,0 +1,74 @@
+#include "spritebatch.h"
+
+#include <cmath>
+#include <cstdlib>
+
+SpriteBatch::SpriteBatch() :
+    vertices(sf::Quads),
+    texture(NULL)
+{
+}
+
+void SpriteBatch::setTexture(const sf::Texture &texture, const sf::IntRect &whiteRect)
+{
+    this->texture = &texture;
+    // sample the middle of the white image so filtering never bleeds in a neighbour
+    whiteTexCoords = sf::Vector2f(whiteRect.left + whiteRect.width / 2.0f,
+                                  whiteRect.top + whiteRect.height / 2.0f);
+}
+
+void SpriteBatch::clear()
+{
+    // keeps the capacity, so a steady frame does not allocate
+    vertices.clear();
+}
+
+void SpriteBatch::add(const sf::Sprite &sprite)
+{
+    addQuad(sprite.getTransform(), sprite.getTextureRect(), sprite.getColor());
+}
+
+void SpriteBatch::addQuad(const sf::Transform &transform, const sf::IntRect &textureRect, const sf::Color &color)
+{
+    float width = static_cast<float>(std::abs(textureRect.width));
+    float height = static_cast<float>(std::abs(textureRect.height));
+
+    float left = static_cast<float>(textureRect.left);
+    float right = left + static_cast<float>(textureRect.width);
+    float top = static_cast<float>(textureRect.top);
+    float bottom = top + static_cast<float>(textureRect.height);
+
+    vertices.append(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+    vertices.append(sf::Vertex(transform.transformPoint(0.f, height), color, sf::Vector2f(left, bottom)));
+    vertices.append(sf::Vertex(transform.transformPoint(width, height), color, sf::Vector2f(right, bottom)));
+    vertices.append(sf::Vertex(transform.transformPoint(width, 0.f), color, sf::Vector2f(right, top)));
+}
+
+void SpriteBatch::addQuad(const sf::Transform &transform, const sf::Vertex *quad)
+{
+    for (int i = 0; i < 4; i += 1) {
+        vertices.append(sf::Vertex(transform.transformPoint(quad[i].position), quad[i].color, quad[i].texCoords));
+    }
+}
+
+void SpriteBatch::addLine(const sf::Vector2f &start, const sf::Vector2f &end, float thickness, const sf::Color &color)
+{
+    sf::Vector2f dir = end - start;
+    float length = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+    if (length == 0.0f)
+        return;
+    sf::Vector2f offset(-dir.y / length * thickness / 2.0f, dir.x / length * thickness / 2.0f);
+
+    vertices.append(sf::Vertex(start + offset, color, whiteTexCoords));
+    vertices.append(sf::Vertex(end + offset, color, whiteTexCoords));
+    vertices.append(sf::Vertex(end - offset, color, whiteTexCoords));
+    vertices.append(sf::Vertex(start - offset, color, whiteTexCoords));
+}
+
+void SpriteBatch::draw(sf::RenderTarget &target, sf::RenderStates states) const
+{
+    if (vertices.getVertexCount() == 0)
+        return;
+    states.texture = texture;
+    target.draw(vertices, states);
+}
@@ -0,0 +1,31 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SFML/Graphics.hpp>
+
+// Collects quads that all sample one texture and submits them with a single
+// draw call. Lines are drawn as thin quads over a solid white texel so they
+// can share the batch.
+class SpriteBatch : public sf::Drawable
+{
+public:
+    SpriteBatch();
+
+    void setTexture(const sf::Texture &texture, const sf::IntRect &whiteRect);
+
+    void clear();
+    void add(const sf::Sprite &sprite);
+    void addQuad(const sf::Transform &transform, const sf::IntRect &textureRect, const sf::Color &color);
+    // a prebuilt quad such as an animation frame, in local space
+    void addQuad(const sf::Transform &transform, const sf::Vertex *quad);
+    void addLine(const sf::Vector2f &start, const sf::Vector2f &end, float thickness, const sf::Color &color);
+
+private:
+    sf::VertexArray vertices;
+    const sf::Texture *texture;
+    sf::Vector2f whiteTexCoords;
+
+    virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+};
+
+#endif // SPRITEBATCH_H
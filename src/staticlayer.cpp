@@ -0,0 +1,84 @@
+#include "staticlayer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+static unsigned int maxChunkSize = 1024;
+
+StaticLayer::StaticLayer()
+{
+}
+
+StaticLayer::~StaticLayer()
+{
+    invalidate();
+}
+
+void StaticLayer::invalidate()
+{
+    for (int i = 0; i < (int)chunks.size(); i += 1) {
+        delete chunks[i].texture;
+    }
+    chunks.clear();
+}
+
+void StaticLayer::build(const std::vector<sf::Sprite> &sprites, const TileMap &tiles, float width, float height)
+{
+    invalidate();
+
+    std::vector<sf::FloatRect> spriteBounds(sprites.size());
+    for (int i = 0; i < (int)sprites.size(); i += 1) {
+        spriteBounds[i] = sprites[i].getGlobalBounds();
+    }
+
+    unsigned int chunkSize = std::min(maxChunkSize, sf::Texture::getMaximumSize());
+    std::vector<const sf::Sprite *> chunkSprites;
+    for (unsigned int top = 0; top < height; top += chunkSize) {
+        for (unsigned int left = 0; left < width; left += chunkSize) {
+            unsigned int chunkWidth = std::min(chunkSize, (unsigned int)width - left);
+            unsigned int chunkHeight = std::min(chunkSize, (unsigned int)height - top);
+            sf::FloatRect chunkRect(left, top, chunkWidth, chunkHeight);
+
+            chunkSprites.clear();
+            for (int i = 0; i < (int)sprites.size(); i += 1) {
+                if (spriteBounds[i].intersects(chunkRect))
+                    chunkSprites.push_back(&sprites[i]);
+            }
+            bool hasTiles = tiles.hasTilesIn(chunkRect);
+            if (chunkSprites.empty() && !hasTiles)
+                continue;
+
+            Chunk chunk;
+            chunk.texture = new sf::RenderTexture();
+            if (!chunk.texture->create(chunkWidth, chunkHeight)) {
+                std::cerr << "Unable to create static layer texture\n";
+                std::exit(1);
+            }
+            chunk.texture->setView(sf::View(chunkRect));
+            chunk.texture->clear(sf::Color::Transparent);
+            for (int i = 0; i < (int)chunkSprites.size(); i += 1) {
+                chunk.texture->draw(*chunkSprites[i]);
+            }
+            // the tile map culls to the chunk's view itself
+            if (hasTiles)
+                chunk.texture->draw(tiles);
+            chunk.texture->display();
+
+            chunk.sprite.setTexture(chunk.texture->getTexture(), true);
+            chunk.sprite.setPosition(left, top);
+            chunks.push_back(chunk);
+        }
+    }
+}
+
+void StaticLayer::draw(sf::RenderTarget &target, sf::RenderStates states) const
+{
+    const sf::View &view = target.getView();
+    sf::Vector2f viewCorner = view.getCenter() - view.getSize() / 2.0f;
+    sf::FloatRect viewRect(viewCorner.x, viewCorner.y, view.getSize().x, view.getSize().y);
+    for (int i = 0; i < (int)chunks.size(); i += 1) {
+        if (chunks[i].sprite.getGlobalBounds().intersects(viewRect))
+            target.draw(chunks[i].sprite, states);
+    }
+}
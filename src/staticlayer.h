@@ -0,0 +1,38 @@
+#ifndef STATICLAYER_H
+#define STATICLAYER_H
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+#include "tilemap.h"
+
+// Geometry that never moves, baked into render textures once so that
+// drawing it costs one textured quad per chunk no matter how many sprites
+// went into it. Chunks outside the target's view are skipped, and chunks
+// with nothing in them are never made.
+class StaticLayer : public sf::Drawable
+{
+public:
+    StaticLayer();
+    ~StaticLayer();
+
+    // sprites are drawn under the tiles
+    void build(const std::vector<sf::Sprite> &sprites, const TileMap &tiles, float width, float height);
+    void invalidate();
+
+private:
+    StaticLayer(const StaticLayer &copy);
+    StaticLayer &operator=(const StaticLayer &copy);
+
+    struct Chunk {
+        sf::RenderTexture *texture;
+        sf::Sprite sprite;
+    };
+
+    std::vector<Chunk> chunks;
+
+    virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+};
+
+#endif // STATICLAYER_H
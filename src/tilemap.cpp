@@ -0,0 +1,78 @@
+#include "tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+
+static float chunkSize = 256.0f;
+
+TileMap::TileMap() :
+    texture(NULL),
+    columns(0),
+    rows(0)
+{
+}
+
+void TileMap::create(const sf::Texture &texture, float width, float height)
+{
+    this->texture = &texture;
+    columns = std::max(1, (int)ceilf(width / chunkSize));
+    rows = std::max(1, (int)ceilf(height / chunkSize));
+    chunks.assign(columns * rows, sf::VertexArray(sf::Quads));
+}
+
+void TileMap::add(const sf::FloatRect &rect, const sf::IntRect &textureRect)
+{
+    int column = std::max(0, std::min((int)(rect.left / chunkSize), columns - 1));
+    int row = std::max(0, std::min((int)(rect.top / chunkSize), rows - 1));
+    sf::VertexArray &chunk = chunks[row * columns + column];
+
+    float left = textureRect.left;
+    float top = textureRect.top;
+    float right = left + textureRect.width;
+    float bottom = top + textureRect.height;
+    chunk.append(sf::Vertex(sf::Vector2f(rect.left, rect.top), sf::Vector2f(left, top)));
+    chunk.append(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top), sf::Vector2f(right, top)));
+    chunk.append(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), sf::Vector2f(right, bottom)));
+    chunk.append(sf::Vertex(sf::Vector2f(rect.left, rect.top + rect.height), sf::Vector2f(left, bottom)));
+}
+
+void TileMap::chunkRange(const sf::FloatRect &rect, int &minColumn, int &minRow, int &maxColumn, int &maxRow) const
+{
+    // Tiles are filed by their top left corner, so a chunk can spill into
+    // its right and lower neighbours; widen the range by a chunk to match.
+    minColumn = std::max(0, (int)floorf(rect.left / chunkSize) - 1);
+    minRow = std::max(0, (int)floorf(rect.top / chunkSize) - 1);
+    maxColumn = std::min(columns - 1, (int)floorf((rect.left + rect.width) / chunkSize));
+    maxRow = std::min(rows - 1, (int)floorf((rect.top + rect.height) / chunkSize));
+}
+
+bool TileMap::hasTilesIn(const sf::FloatRect &rect) const
+{
+    int minColumn, minRow, maxColumn, maxRow;
+    chunkRange(rect, minColumn, minRow, maxColumn, maxRow);
+    for (int row = minRow; row <= maxRow; row += 1) {
+        for (int column = minColumn; column <= maxColumn; column += 1) {
+            const sf::VertexArray &chunk = chunks[row * columns + column];
+            if (chunk.getVertexCount() > 0 && chunk.getBounds().intersects(rect))
+                return true;
+        }
+    }
+    return false;
+}
+
+void TileMap::draw(sf::RenderTarget &target, sf::RenderStates states) const
+{
+    const sf::View &view = target.getView();
+    sf::Vector2f viewCorner = view.getCenter() - view.getSize() / 2.0f;
+    int minColumn, minRow, maxColumn, maxRow;
+    chunkRange(sf::FloatRect(viewCorner, view.getSize()), minColumn, minRow, maxColumn, maxRow);
+
+    states.texture = texture;
+    for (int row = minRow; row <= maxRow; row += 1) {
+        for (int column = minColumn; column <= maxColumn; column += 1) {
+            const sf::VertexArray &chunk = chunks[row * columns + column];
+            if (chunk.getVertexCount() > 0)
+                target.draw(chunk, states);
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+// Tiles sorted into a grid of chunks, each a prebuilt vertex array. Drawing
+// skips every chunk outside the target's view.
+class TileMap : public sf::Drawable
+{
+public:
+    TileMap();
+
+    // clears the map
+    void create(const sf::Texture &texture, float width, float height);
+    void add(const sf::FloatRect &rect, const sf::IntRect &textureRect);
+    bool hasTilesIn(const sf::FloatRect &rect) const;
+
+private:
+    const sf::Texture *texture;
+    int columns;
+    int rows;
+    std::vector<sf::VertexArray> chunks;
+
+    void chunkRange(const sf::FloatRect &rect, int &minColumn, int &minRow, int &maxColumn, int &maxRow) const;
+    virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+};
+
+#endif // TILEMAP_H
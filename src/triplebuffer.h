@@ -0,0 +1,56 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Hands values from one writer thread to one reader thread without locks.
+// The writer fills back() and publishes it; the reader calls update() to
+// take the newest published value, if there is one, as front(). Neither
+// side ever waits for the other. A value the reader has not picked up yet
+// is replaced by the next one the writer publishes.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() :
+        backIndex(0),
+        middle(1),
+        frontIndex(2)
+    {
+    }
+
+    // writer side
+    T &back() {
+        return buffers[backIndex];
+    }
+    void publish() {
+        int old = middle.exchange(backIndex | freshBit, std::memory_order_acq_rel);
+        backIndex = old & indexMask;
+    }
+
+    // reader side; returns whether front() changed
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & freshBit))
+            return false;
+        int old = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = old & indexMask;
+        return true;
+    }
+    const T &front() const {
+        return buffers[frontIndex];
+    }
+
+private:
+    static const int freshBit = 4;
+    static const int indexMask = 3;
+
+    T buffers[3];
+    int backIndex;
+    std::atomic<int> middle;
+    int frontIndex;
+
+    TripleBuffer(const TripleBuffer &);
+    TripleBuffer &operator=(const TripleBuffer &);
+};
+
+#endif // TRIPLEBUFFER_H
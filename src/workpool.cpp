@@ -0,0 +1,80 @@
+#include "workpool.h"
+
+#include <thread>
+#include <vector>
+
+WorkPool::WorkPool(int threadCount) :
+    count(threadCount),
+    nextQueue(0)
+{
+    if (count <= 0)
+        count = std::thread::hardware_concurrency();
+    if (count <= 0)
+        count = 1;
+    queues = new Queue[count];
+}
+
+WorkPool::~WorkPool()
+{
+    delete[] queues;
+}
+
+int WorkPool::threadCount() const
+{
+    return count;
+}
+
+void WorkPool::add(std::function<void()> task)
+{
+    queues[nextQueue].tasks.push_back(task);
+    nextQueue = (nextQueue + 1) % count;
+}
+
+void WorkPool::run()
+{
+    // this thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < count; i += 1) {
+        threads.push_back(std::thread(&WorkPool::work, this, i));
+    }
+    work(0);
+    for (int i = 0; i < (int)threads.size(); i += 1) {
+        threads[i].join();
+    }
+    nextQueue = 0;
+}
+
+void WorkPool::work(int index)
+{
+    std::function<void()> task;
+    while (take(index, task) || steal(index, task)) {
+        task();
+    }
+}
+
+bool WorkPool::take(int index, std::function<void()> &task)
+{
+    Queue &queue = queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkPool::steal(int index, std::function<void()> &task)
+{
+    // nothing is added while running, so once every queue has been seen
+    // empty the batch is done
+    for (int i = 1; i < count; i += 1) {
+        Queue &queue = queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,44 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Runs a batch of independent tasks on a fixed number of threads. Each
+// worker has its own queue and takes from its back; a worker that runs dry
+// steals from the front of the others, so tasks of uneven length still keep
+// every thread busy until the batch is done.
+class WorkPool
+{
+public:
+    // threadCount 0 means one per hardware thread
+    WorkPool(int threadCount = 0);
+    ~WorkPool();
+
+    int threadCount() const;
+
+    // Call before run(). Tasks must not add more tasks.
+    void add(std::function<void()> task);
+    // Runs every added task and returns once they have all finished.
+    void run();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    int count;
+    Queue *queues;
+    int nextQueue;
+
+    void work(int index);
+    bool take(int index, std::function<void()> &task);
+    bool steal(int index, std::function<void()> &task);
+
+    WorkPool(const WorkPool &);
+    WorkPool &operator=(const WorkPool &);
+};
+
+#endif // WORKPOOL_H
@@ -0,0 +1,997 @@
+#include "world.h"
+#include "profiler.h"
+#include "mapformat.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+static const struct {
+    const char *name;
+    float Tuning::*field;
+} tuningFields[] = {
+    {"maxPlayerSpeed", &Tuning::maxPlayerSpeed},
+    {"playerMoveForceAir", &Tuning::playerMoveForceAir},
+    {"playerMoveForceGround", &Tuning::playerMoveForceGround},
+    {"jumpForce", &Tuning::jumpForce},
+    {"clawShootSpeed", &Tuning::clawShootSpeed},
+    {"minClawDist", &Tuning::minClawDist},
+    {"retractClawDist", &Tuning::retractClawDist},
+    {"clawReelInSpeedAttached", &Tuning::clawReelInSpeedAttached},
+    {"clawReelInSpeedDetached", &Tuning::clawReelInSpeedDetached},
+    {"jnAccMin", &Tuning::jnAccMin},
+    {"maxReelOutLength", &Tuning::maxReelOutLength},
+};
+// the foot sensor is a thin strip just under the player, a little narrower
+// than the body so walls do not count as ground
+static float footSensorInset = 4.0f;
+static float footSensorTop = 1.0f;
+static float footSensorBottom = 3.0f;
+
+enum CollisionType {
+    DefaultCollisionType,
+    FootSensorCollisionType,
+};
+
+
+static float sign(float x) {
+    if (x < 0) {
+        return -1.0f;
+    } else if (x > 0) {
+        return 1.0f;
+    } else {
+        return 0.0f;
+    }
+}
+
+void PlayerInput::reset()
+{
+    xAxis = 0.0f;
+    yAxis = 0.0f;
+    btnJump = false;
+    btnFireGrapple = false;
+    btnUnhookGrapple = false;
+    btnReelOut = false;
+}
+
+World::World(ResourceBundle *bundle, const Tuning &tuning) :
+    tuning(tuning),
+    bundle(bundle)
+{
+    timeStep = 1.0f/60.0f;
+    stepIndex = 0;
+    arenaWidth = 0.0f;
+    arenaHeight = 0.0f;
+    tileWidth = 0.0f;
+    tileHeight = 0.0f;
+    armLength = 50.0f;
+    clawRadius = 0.0f;
+
+    // chipmunk's broadphase orders pairs by shape id, which comes from a
+    // global counter; start every world from zero so they all collide the
+    // same way
+    cpResetShapeIdCounter();
+    space = cpSpaceNew();
+    cpSpaceSetGravity(space, cpv(0, 1000));
+    cpSpaceSetDamping(space, 0.95f);
+    cpSpaceAddCollisionHandler(space, DefaultCollisionType, DefaultCollisionType,
+                               NULL, NULL, postSolveCollisionCallback, NULL, this);
+    cpSpaceAddCollisionHandler(space, FootSensorCollisionType, DefaultCollisionType,
+                               footBeginCallback, NULL, NULL, footSeparateCallback, this);
+}
+
+World::~World()
+{
+    // A claw can be hooked to another player's body or claw, and removing
+    // its joint wakes both bodies, so every claw comes out of the space
+    // before anything is freed.
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        Player *player = players[i];
+        if (player->body) {
+            playerDeactivateClaw(player);
+        }
+    }
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        Player *player = players[i];
+        if (player->body) {
+            cpConstraintFree(&player->pivotJoint->constraint);
+            cpConstraintFree(&player->slideJoint->constraint);
+            cpShapeFree(player->clawShape);
+            cpBodyFree(player->clawBody);
+
+            cpSpaceRemoveShape(space, player->footShape);
+            cpShapeFree(player->footShape);
+            cpSpaceRemoveShape(space, player->shape);
+            cpShapeFree(player->shape);
+            cpSpaceRemoveBody(space, player->body);
+            cpBodyFree(player->body);
+        }
+        delete player;
+    }
+    for (int i = 0; i < (int)tileLayers.size(); i += 1) {
+        delete tileLayers[i];
+    }
+    for (int i = 0; i < (int)platforms.size(); i += 1) {
+        Platform *platform = platforms[i];
+        cpSpaceRemoveShape(space, platform->shape);
+        cpShapeFree(platform->shape);
+        cpBodyFree(platform->body);
+        delete platform;
+    }
+    cpSpaceFree(space);
+}
+
+bool Tuning::set(const std::string &name, float value)
+{
+    if (name == "maxJumpFrames") {
+        maxJumpFrames = (int)value;
+        return true;
+    }
+    for (int i = 0; i < (int)(sizeof(tuningFields) / sizeof(tuningFields[0])); i += 1) {
+        if (name == tuningFields[i].name) {
+            this->*tuningFields[i].field = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+World::Player::Player(int i, World *world)
+{
+    index = i;
+
+    clawFixtureUserData.world = world;
+    clawFixtureUserData.type = ClawFixture;
+    clawFixtureUserData.player = this;
+    clawFixtureUserData.canGrapple = true;
+}
+
+void World::PlayerState::resize(int count)
+{
+    input.resize(count);
+    clawState.resize(count, ClawStateRetracted);
+    pointAngle.resize(count, 0.0f);
+    facing.resize(count, 1.0f);
+    aimUnit.resize(count, cpv(1, 0));
+    aimStartPos.resize(count, cpvzero);
+    footContacts.resize(count, 0);
+    jumpFrameCount.resize(count, 0);
+}
+
+World::Platform::Platform(World *world)
+{
+    ident.world = world;
+    ident.type = PlatformFixture;
+    ident.player = NULL;
+    ident.canGrapple = true;
+}
+
+// footContacts is kept up to date by the foot sensor's contacts starting
+// and ending rather than by querying for ground every step.
+cpBool World::footBeginCallback(cpArbiter *arb, cpSpace *space, void *data)
+{
+    cpShape *footShape, *otherShape;
+    cpArbiterGetShapes(arb, &footShape, &otherShape);
+    World *world = reinterpret_cast<World *>(data);
+    Player *player = reinterpret_cast<Player *>(cpShapeGetUserData(footShape));
+    world->playerState.footContacts[player->index] += 1;
+    return cpTrue;
+}
+
+void World::footSeparateCallback(cpArbiter *arb, cpSpace *space, void *data)
+{
+    cpShape *footShape, *otherShape;
+    cpArbiterGetShapes(arb, &footShape, &otherShape);
+    World *world = reinterpret_cast<World *>(data);
+    Player *player = reinterpret_cast<Player *>(cpShapeGetUserData(footShape));
+    world->playerState.footContacts[player->index] -= 1;
+    assert(world->playerState.footContacts[player->index] >= 0);
+}
+
+void World::postSolveCollisionCallback(cpArbiter *arb, cpSpace *space, void *data)
+{
+    World *world = reinterpret_cast<World *>(data);
+    world->onPostSolveCollision(arb);
+}
+
+// Points at the next size bytes of a compiled map, or gives up if the map
+// is shorter than its header says.
+static const unsigned char *mapBytes(const std::vector<unsigned char> &buffer, size_t &offset, size_t size)
+{
+    if (size > buffer.size() - offset) {
+        std::cerr << "compiled map is truncated\n";
+        std::exit(1);
+    }
+    const unsigned char *bytes = buffer.data() + offset;
+    offset += size;
+    return bytes;
+}
+
+template <typename T>
+static void readMap(const std::vector<unsigned char> &buffer, size_t &offset, T &value)
+{
+    memcpy(&value, mapBytes(buffer, offset, sizeof(T)), sizeof(T));
+}
+
+static RuckSackImage *mapImage(ResourceBundle *bundle, int id)
+{
+    if (id < 0 || id >= ImageIdCount) {
+        std::cerr << "compiled map has an unknown image; rebuild the assets\n";
+        std::exit(1);
+    }
+    return bundle->getImage((ImageId)id);
+}
+
+// Maps are compiled by grapple_mapc when the assets are bundled; see
+// mapformat.h for the layout.
+void World::loadMap(const std::string &key)
+{
+    std::vector<unsigned char> buffer;
+    bundle->readFile(key, buffer);
+
+    size_t offset = 0;
+    MapHeader header;
+    readMap(buffer, offset, header);
+    if (memcmp(header.magic, mapMagic, sizeof(mapMagic)) != 0 || header.version != mapFormatVersion) {
+        std::cerr << key << " is not a compiled map for this build\n";
+        std::exit(1);
+    }
+    mapKey = key;
+    stepIndex = 0;
+    arenaWidth = header.width;
+    arenaHeight = header.height;
+    tileWidth = header.tileWidth;
+    tileHeight = header.tileHeight;
+
+    for (int i = 0; i < (int)header.platformCount; i += 1) {
+        MapPlatform platform;
+        readMap(buffer, offset, platform);
+        RuckSackImage *image = (platform.image >= 0) ? mapImage(bundle, platform.image) : NULL;
+        createPlatform(cpv(platform.x, platform.y), cpv(platform.width, platform.height), image,
+                !!platform.canGrapple);
+    }
+
+    if (header.startCount > (uint32_t)mapMaxPlayers) {
+        std::cerr << key << " has " << header.startCount << " starts, at most " << mapMaxPlayers
+                  << " are allowed\n";
+        std::exit(1);
+    }
+    for (int i = 0; i < (int)header.startCount; i += 1) {
+        MapStart start;
+        readMap(buffer, offset, start);
+        // with no duplicates, this leaves no gaps either
+        if (start.player < 0 || start.player >= (int)header.startCount) {
+            std::cerr << key << ": start for player " << start.player << " is out of range\n";
+            std::exit(1);
+        }
+        initPlayer(start.player, cpv(start.x, start.y));
+    }
+
+    for (int i = 0; i < (int)header.tileLayerCount; i += 1) {
+        MapTileLayer layer;
+        readMap(buffer, offset, layer);
+        TileLayer *tileLayer = new TileLayer();
+        tileLayer->width = layer.width;
+        tileLayer->height = layer.height;
+        tileLayer->visible = !!layer.visible;
+        tileLayer->tiles.resize(tileLayer->width * tileLayer->height, NULL);
+        const unsigned char *tiles = mapBytes(buffer, offset, tileLayer->tiles.size() * sizeof(uint16_t));
+        for (int j = 0; j < (int)tileLayer->tiles.size(); j += 1) {
+            uint16_t tile;
+            memcpy(&tile, tiles + j * sizeof(uint16_t), sizeof(uint16_t));
+            if (tile == mapNoImage)
+                continue;
+            tileLayer->tiles[j] = mapImage(bundle, tile);
+        }
+        tileLayers.push_back(tileLayer);
+    }
+
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        if (!players[i]->body) {
+            std::cerr << "map has no start for player " << i << "\n";
+            std::exit(1);
+        }
+    }
+}
+
+void World::step()
+{
+    savePrevState();
+
+    {
+        Profiler::Zone zone("pivot joints");
+        for (int i = 0; i < (int)players.size(); i += 1) {
+            Player *player = players[i];
+            if (player->queuePivotJoint) {
+                player->queuePivotJoint = false;
+                playerHookClaw(player);
+            }
+        }
+    }
+
+    {
+        Profiler::Zone zone("claw sweep");
+        for (int i = 0; i < (int)players.size(); i += 1) {
+            sweepClaw(i);
+        }
+    }
+
+    {
+        Profiler::Zone zone("cpSpaceStep");
+        cpSpaceStep(space, timeStep);
+    }
+
+    {
+        Profiler::Zone zone("players");
+        for (int i = 0; i < (int)players.size(); i += 1) {
+            stepPlayer(i);
+        }
+    }
+
+    stepIndex += 1;
+}
+
+// One player's part of a saved state. It has room for every claw joint
+// whether or not it exists, so a state is always the same size and saving
+// and restoring are straight copies.
+struct SavedPlayer {
+    PlayerInput input;
+    cpVect pos;
+    cpVect vel;
+    float facing;
+    float pointAngle;
+    cpVect aimUnit;
+    cpVect aimStartPos;
+    int jumpFrameCount;
+    cpVect prevPos;
+    cpVect prevClawPos;
+    cpVect prevAimStartPos;
+
+    World::ClawState clawState;
+    cpVect clawPos;
+    cpVect clawVel;
+    cpFloat clawAngle;
+    cpFloat slideMax;
+    cpFloat slideJnAcc;
+
+    bool hasPivot;
+    bool queuePivotJoint;
+    int pivotBodyId;
+    cpVect pivotAnchr1;
+    cpVect pivotAnchr2;
+    cpVect pivotJAcc;
+};
+
+struct SavedWorld {
+    int stepIndex;
+    int playerCount;
+};
+
+size_t World::stateSize(int playerCount)
+{
+    return sizeof(SavedWorld) + playerCount * sizeof(SavedPlayer);
+}
+
+void World::saveState(std::vector<unsigned char> &buffer)
+{
+    // the same size every time, so a reused buffer never reallocates
+    buffer.resize(stateSize(players.size()));
+    unsigned char *out = buffer.data();
+
+    SavedWorld header;
+    header.stepIndex = stepIndex;
+    header.playerCount = players.size();
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+
+    for (int i = 0; i < (int)players.size(); i += 1, out += sizeof(SavedPlayer)) {
+        // zeroed so padding and unused fields hash the same every time
+        SavedPlayer saved;
+        memset(static_cast<void *>(&saved), 0, sizeof(saved));
+
+        Player *player = players[i];
+        if (!player->body) {
+            memcpy(out, &saved, sizeof(saved));
+            continue;
+        }
+
+        saved.input = playerState.input[i];
+        saved.pos = player->body->p;
+        saved.vel = player->body->v;
+        saved.facing = playerState.facing[i];
+        saved.pointAngle = playerState.pointAngle[i];
+        saved.aimUnit = playerState.aimUnit[i];
+        saved.aimStartPos = playerState.aimStartPos[i];
+        saved.jumpFrameCount = playerState.jumpFrameCount[i];
+        saved.prevPos = player->prevPos;
+        saved.prevClawPos = player->prevClawPos;
+        saved.prevAimStartPos = player->prevAimStartPos;
+
+        saved.clawState = playerState.clawState[i];
+        if (saved.clawState != ClawStateRetracted) {
+            saved.clawPos = player->clawBody->p;
+            saved.clawVel = player->clawBody->v;
+            saved.clawAngle = player->clawBody->a;
+            saved.slideMax = player->slideJoint->max;
+            saved.slideJnAcc = player->slideJoint->jnAcc;
+
+            saved.hasPivot = player->pivotJointActive;
+            if (saved.hasPivot) {
+                cpConstraint *pivot = &player->pivotJoint->constraint;
+                saved.queuePivotJoint = player->queuePivotJoint;
+                saved.pivotBodyId = bodyToId(pivot->b);
+                saved.pivotAnchr1 = player->pivotJoint->anchr1;
+                saved.pivotAnchr2 = player->pivotJoint->anchr2;
+                saved.pivotJAcc = player->pivotJoint->jAcc;
+            }
+        }
+        memcpy(out, &saved, sizeof(saved));
+    }
+}
+
+void World::loadState(const std::vector<unsigned char> &buffer)
+{
+    assert(buffer.size() == stateSize(players.size()));
+    const unsigned char *in = buffer.data();
+
+    SavedWorld header;
+    memcpy(&header, in, sizeof(header));
+    in += sizeof(header);
+    assert(header.playerCount == (int)players.size());
+
+    // Take every dynamic object out of the space, which also drops the
+    // contacts chipmunk has cached for them, then add them back in a fixed
+    // order. Whatever the world was doing before, it continues the same way.
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        Player *player = players[i];
+        if (!player->body)
+            continue;
+        playerDeactivateClaw(player);
+        cpSpaceRemoveShape(space, player->footShape);
+        cpSpaceRemoveShape(space, player->shape);
+        cpSpaceRemoveBody(space, player->body);
+    }
+    // Removing the shapes ended every foot contact. The next step finds them
+    // again, so footContacts is not part of the state.
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        assert(playerState.footContacts[i] == 0);
+    }
+
+    stepIndex = header.stepIndex;
+    for (int i = 0; i < (int)players.size(); i += 1, in += sizeof(SavedPlayer)) {
+        Player *player = players[i];
+        if (!player->body)
+            continue;
+
+        SavedPlayer saved;
+        memcpy(&saved, in, sizeof(saved));
+
+        playerState.input[i] = saved.input;
+        playerState.facing[i] = saved.facing;
+        playerState.pointAngle[i] = saved.pointAngle;
+        playerState.aimUnit[i] = saved.aimUnit;
+        playerState.aimStartPos[i] = saved.aimStartPos;
+        playerState.jumpFrameCount[i] = saved.jumpFrameCount;
+        player->prevPos = saved.prevPos;
+        player->prevClawPos = saved.prevClawPos;
+        player->prevAimStartPos = saved.prevAimStartPos;
+
+        cpBodySetPos(player->body, saved.pos);
+        cpBodySetVel(player->body, saved.vel);
+        cpSpaceAddBody(space, player->body);
+        cpSpaceAddShape(space, player->shape);
+        cpSpaceAddShape(space, player->footShape);
+
+        playerState.clawState[i] = saved.clawState;
+        if (saved.clawState == ClawStateRetracted)
+            continue;
+
+        playerActivateClaw(player, saved.clawPos, saved.clawAngle, saved.clawVel);
+        cpSlideJointSetMax(&player->slideJoint->constraint, saved.slideMax);
+        player->slideJoint->jnAcc = saved.slideJnAcc;
+        if (!saved.hasPivot)
+            continue;
+
+        player->queuePivotJoint = saved.queuePivotJoint;
+        cpPivotJointInit(player->pivotJoint, player->clawBody, idToBody(saved.pivotBodyId),
+                         saved.pivotAnchr1, saved.pivotAnchr2);
+        player->pivotJoint->jAcc = saved.pivotJAcc;
+        player->pivotJointActive = true;
+    }
+
+    // pivots go in last because they can hold on to any player's claw
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        Player *player = players[i];
+        if (player->pivotJointActive && !player->queuePivotJoint)
+            cpSpaceAddConstraint(space, &player->pivotJoint->constraint);
+    }
+}
+
+// FNV-1a over raw bits, so -0 and 0 or two NaNs that print the same still
+// count as different
+static unsigned long long fnvOffset = 14695981039346656037ULL;
+
+template <typename T>
+static void hashValue(unsigned long long &hash, const T &value)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+    for (int i = 0; i < (int)sizeof(T); i += 1) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+unsigned long long World::checksum() const
+{
+    unsigned long long hash = fnvOffset;
+    hashValue(hash, stepIndex);
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        hashValue(hash, playerChecksum(i));
+    }
+    return hash;
+}
+
+unsigned long long World::playerChecksum(int index) const
+{
+    const Player *player = players[index];
+    unsigned long long hash = fnvOffset;
+    if (!player->body)
+        return hash;
+
+    hashValue(hash, player->body->p.x);
+    hashValue(hash, player->body->p.y);
+    hashValue(hash, player->body->v.x);
+    hashValue(hash, player->body->v.y);
+    hashValue(hash, playerState.jumpFrameCount[index]);
+    hashValue(hash, (int)playerState.clawState[index]);
+    if (playerState.clawState[index] == ClawStateRetracted)
+        return hash;
+
+    hashValue(hash, player->clawBody->p.x);
+    hashValue(hash, player->clawBody->p.y);
+    hashValue(hash, player->clawBody->v.x);
+    hashValue(hash, player->clawBody->v.y);
+    hashValue(hash, player->slideJoint->max);
+    hashValue(hash, player->pivotJointActive);
+    return hash;
+}
+
+// Every body carries its id in its user data: the index of its platform or
+// player, and which kind of body it is. Ids do not depend on how many of
+// anything there are, so they survive a save and restore.
+enum BodyKind {
+    PlatformBody,
+    PlayerBody,
+    ClawBody,
+    BodyKindCount,
+};
+
+static void setBodyId(cpBody *body, int index, BodyKind kind)
+{
+    cpBodySetUserData(body, (cpDataPointer)(intptr_t)(index * BodyKindCount + kind));
+}
+
+int World::bodyToId(cpBody *body)
+{
+    return (int)(intptr_t)cpBodyGetUserData(body);
+}
+
+cpBody *World::idToBody(int id)
+{
+    int index = id / BodyKindCount;
+    switch (id % BodyKindCount) {
+    case PlatformBody:
+        return platforms[index]->body;
+    case PlayerBody:
+        return players[index]->body;
+    default:
+        return players[index]->clawBody;
+    }
+}
+
+void World::savePrevState()
+{
+    for (int i = 0; i < (int)players.size(); i += 1) {
+        Player *player = players[i];
+        player->prevPos = player->body->p;
+        player->prevAimStartPos = playerState.aimStartPos[i];
+        if (playerState.clawState[i] != ClawStateRetracted)
+            player->prevClawPos = player->clawBody->p;
+    }
+}
+
+void World::stepPlayer(int index)
+{
+    Player *player = players[index];
+    const PlayerInput &input = playerState.input[index];
+    ClawState &clawState = playerState.clawState[index];
+    int &jumpFrameCount = playerState.jumpFrameCount[index];
+    float &pointAngle = playerState.pointAngle[index];
+    cpVect &aimUnit = playerState.aimUnit[index];
+    cpVect &aimStartPos = playerState.aimStartPos[index];
+    bool grounded = playerState.footContacts[index] > 0;
+
+    cpVect pos = player->body->p;
+    cpVect curVel = cpBodyGetVel(player->body);
+
+    float moveForce = grounded ? tuning.playerMoveForceGround : tuning.playerMoveForceAir;
+    if (input.xAxis < 0) {
+        if (curVel.x >= -tuning.maxPlayerSpeed) {
+            cpBodyApplyImpulse(player->body, cpv(-moveForce, 0), cpvzero);
+        }
+    } else if (input.xAxis > 0) {
+        if (curVel.x <= tuning.maxPlayerSpeed) {
+            cpBodyApplyImpulse(player->body, cpv(moveForce, 0), cpvzero);
+        }
+    }
+
+
+    if (input.btnJump && grounded) {
+        jumpFrameCount = 1;
+    } else if (!input.btnJump && jumpFrameCount > 0) {
+        jumpFrameCount = 0;
+    }
+    if (jumpFrameCount > tuning.maxJumpFrames) {
+        jumpFrameCount = 0;
+    } else if (jumpFrameCount > 0) {
+        jumpFrameCount += 1;
+        cpBodyApplyImpulse(player->body, cpv(0, -tuning.jumpForce), cpvzero);
+    }
+
+    float scaleSign = sign(input.xAxis);
+    if (scaleSign != 0) {
+        playerState.facing[index] = scaleSign;
+    }
+    if (input.xAxis != 0 || input.yAxis != 0) {
+        pointAngle = atan2(input.yAxis, input.xAxis);
+    }
+    aimUnit = cpv(cos(pointAngle), sin(pointAngle));
+    aimStartPos = cpvadd(pos, cpvmult(aimUnit, armLength));
+
+    if (input.btnFireGrapple && clawState == ClawStateRetracted) {
+        playerActivateClaw(player, aimStartPos, pointAngle, cpvadd(curVel, cpvmult(aimUnit, tuning.clawShootSpeed)));
+        player->prevClawPos = aimStartPos;
+        clawState = ClawStateAir;
+    } else if (input.btnFireGrapple && clawState == ClawStateAttached) {
+        playerReelClawOneFrame(player, false);
+    } else if (input.btnFireGrapple && clawState == ClawStateDetached) {
+        playerReelClawOneFrame(player, true);
+    } else if (input.btnUnhookGrapple && clawState == ClawStateDetached) {
+        playerReelClawOneFrame(player, true);
+    } else if (input.btnUnhookGrapple && (clawState == ClawStateAttached || clawState == ClawStateAir)) {
+        playerUnhookClaw(player);
+    } else if (input.btnReelOut && clawState == ClawStateAttached) {
+        playerReelOutClawOneFrame(player);
+    }
+
+    if (clawState != ClawStateRetracted) {
+        if (player->slideJoint->jnAcc < tuning.jnAccMin) {
+            // too tense. give it some slack.
+            float currentLength = cpSlideJointGetMax(&player->slideJoint->constraint);
+            float newMax = currentLength + getPlayerReelInSpeed(player);
+            cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
+            player->slideJoint->jnAcc = tuning.jnAccMin;
+        }
+    }
+}
+
+void World::onPostSolveCollision(cpArbiter *arb)
+{
+    cpShape *a;
+    cpShape *b;
+    cpArbiterGetShapes(arb, &a, &b);
+
+    FixtureIdent *identA = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(a));
+    FixtureIdent *identB = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(b));
+
+    if (identA) {
+        switch (identA->type) {
+        case ClawFixture:
+            handleClawHit(identA->player, arb, b);
+            return;
+        case PlatformFixture:
+            return;
+        }
+        std::cerr << "Unrecognized fixture identification type: " << identA->type << "\n";
+        assert(0);
+    }
+    if (identB) {
+        switch (identB->type) {
+        case ClawFixture:
+            handleClawHit(identB->player, arb, a);
+            return;
+        case PlatformFixture:
+            return;
+        }
+        std::cerr << "Unrecognized fixture identification type: " << identB->type << "\n";
+        assert(0);
+    }
+}
+
+void World::handleClawHit(World::Player *player, cpArbiter *arb, cpShape *otherShape)
+{
+    if (playerState.clawState[player->index] != ClawStateAir || player->queuePivotJoint)
+        return;
+
+    FixtureIdent *ident = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(otherShape));
+    bool canGrapple = !ident || ident->canGrapple;
+
+    if (canGrapple) {
+        cpContactPointSet pointSet = cpArbiterGetContactPointSet(arb);
+
+        // average the contact points to get a single value
+        float scaleVal = 1 / (float) pointSet.count;
+        cpVect pt = cpvzero;
+        for (int i = 0; i < pointSet.count; i += 1) {
+            pt = cpvadd(pt, cpvmult(pointSet.points[i].point, scaleVal));
+        }
+
+        cpVect shapeAnchor = cpvsub(pt, otherShape->body->p);
+        cpVect clawAnchor = cpvsub(pt, player->clawBody->p);
+
+        cpPivotJointInit(player->pivotJoint, player->clawBody, otherShape->body, clawAnchor, shapeAnchor);
+        player->pivotJointActive = true;
+        player->queuePivotJoint = true;
+    } else {
+        // kill velocity of the grapple body
+        cpBodySetVel(player->clawBody, cpvzero);
+        playerState.clawState[player->index] = ClawStateDetached;
+    }
+}
+
+struct ClawSweep {
+    World::Player *player;
+    // the segment being queried, and the one the first hit so far came from
+    int ray;
+    int hitRay;
+    cpShape *shape;
+    cpFloat t;
+    cpVect n;
+};
+
+static void clawSweepCallback(cpShape *shape, cpFloat t, cpVect n, void *data)
+{
+    ClawSweep *sweep = reinterpret_cast<ClawSweep*>(data);
+    World::Player *player = sweep->player;
+    if (shape->sensor || shape == player->clawShape || shape->body == player->body)
+        return;
+    if (!sweep->shape || t < sweep->t) {
+        sweep->hitRay = sweep->ray;
+        sweep->shape = shape;
+        sweep->t = t;
+        sweep->n = n;
+    }
+}
+
+// A flying claw covers clawShootSpeed * timeStep in a step, enough to pass
+// through a thin platform without chipmunk ever seeing them touch. So the
+// path it is about to take is checked first, and it hooks wherever that
+// path first meets something.
+void World::sweepClaw(int index)
+{
+    Player *player = players[index];
+    if (playerState.clawState[index] != ClawStateAir || player->queuePivotJoint)
+        return;
+
+    // the velocity the step will move it by, damped and with gravity added
+    cpVect vel = cpvadd(cpvmult(player->clawBody->v, cpfpow(cpSpaceGetDamping(space), timeStep)),
+                        cpvmult(cpSpaceGetGravity(space), timeStep));
+    cpVect start = player->clawBody->p;
+    cpVect end = cpvadd(start, cpvmult(vel, timeStep));
+    // the center and both edges of the claw, so nothing narrower than it
+    // slips past the middle
+    cpVect side = cpvmult(cpvperp(cpvnormalize_safe(cpvsub(end, start))), clawRadius);
+    cpVect offsets[] = {cpvzero, side, cpvneg(side)};
+
+    ClawSweep sweep;
+    sweep.player = player;
+    sweep.hitRay = 0;
+    sweep.shape = NULL;
+    sweep.t = 1.0f;
+    sweep.n = cpvzero;
+    for (sweep.ray = 0; sweep.ray < 3; sweep.ray += 1) {
+        cpVect offset = offsets[sweep.ray];
+        cpSpaceSegmentQuery(space, cpvadd(start, offset), cpvadd(end, offset), CP_ALL_LAYERS, CP_NO_GROUP,
+                            clawSweepCallback, &sweep);
+    }
+    if (!sweep.shape)
+        return;
+
+    // an edge hit leaves the center a radius off the surface already; the
+    // center stops a radius short of where it hit
+    cpVect center = cpvlerp(start, end, sweep.t);
+    cpVect hit = cpvadd(center, offsets[sweep.hitRay]);
+    if (sweep.hitRay == 0)
+        center = cpvadd(hit, cpvmult(sweep.n, clawRadius));
+    cpBodySetPos(player->clawBody, center);
+    cpBodySetVel(player->clawBody, cpvzero);
+
+    FixtureIdent *ident = reinterpret_cast<FixtureIdent*>(cpShapeGetUserData(sweep.shape));
+    if (ident && !ident->canGrapple) {
+        playerState.clawState[index] = ClawStateDetached;
+        return;
+    }
+    cpBody *other = sweep.shape->body;
+    cpPivotJointInit(player->pivotJoint, player->clawBody, other,
+                     cpBodyWorld2Local(player->clawBody, hit), cpBodyWorld2Local(other, hit));
+    player->pivotJointActive = true;
+    playerHookClaw(player);
+}
+
+// Adds a pivot joint that is set up and not queued, and shortens the rope
+// to where the claw is.
+void World::playerHookClaw(World::Player *player)
+{
+    cpSpaceAddConstraint(space, &player->pivotJoint->constraint);
+    playerState.clawState[player->index] = ClawStateAttached;
+    float clawDist = cpvlength(cpvsub(cpBodyGetPos(player->clawBody), cpBodyGetPos(player->body)));
+    float newMax = std::max(clawDist, tuning.minClawDist);
+    cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
+}
+
+// The claw's body, shape and joints are made once per player in initPlayer
+// and only go in and out of the space after that, so firing and retracting
+// never touch the heap.
+void World::playerActivateClaw(World::Player *player, cpVect pos, float angle, cpVect vel)
+{
+    cpBodySetPos(player->clawBody, pos);
+    cpBodySetAngle(player->clawBody, angle);
+    cpBodySetVel(player->clawBody, vel);
+    cpBodySetAngVel(player->clawBody, 0.0f);
+    cpSpaceAddBody(space, player->clawBody);
+    cpSpaceAddShape(space, player->clawShape);
+
+    cpSlideJointSetMax(&player->slideJoint->constraint, tuning.maxReelOutLength);
+    player->slideJoint->jnAcc = 0.0f;
+    cpSpaceAddConstraint(space, &player->slideJoint->constraint);
+}
+
+void World::playerRetractClaw(World::Player *player)
+{
+    ClawState &clawState = playerState.clawState[player->index];
+    assert(clawState != ClawStateRetracted);
+
+    playerDeactivateClaw(player);
+    clawState = ClawStateRetracted;
+}
+
+void World::playerDeactivateClaw(World::Player *player)
+{
+    if (playerState.clawState[player->index] == ClawStateRetracted)
+        return;
+
+    playerUnhookClaw(player);
+    cpSpaceRemoveConstraint(space, &player->slideJoint->constraint);
+    cpSpaceRemoveShape(space, player->clawShape);
+    cpSpaceRemoveBody(space, player->clawBody);
+}
+
+void World::playerUnhookClaw(World::Player *player)
+{
+    ClawState &clawState = playerState.clawState[player->index];
+    if (clawState != ClawStateRetracted)
+        clawState = ClawStateDetached;
+
+    if (player->pivotJointActive) {
+        // a queued joint has not been added to the space yet
+        if (!player->queuePivotJoint)
+            cpSpaceRemoveConstraint(space, &player->pivotJoint->constraint);
+        player->pivotJointActive = false;
+        player->queuePivotJoint = false;
+    }
+}
+
+void World::playerReelClawOneFrame(World::Player *player, bool retract)
+{
+    cpVect clawPos = player->clawBody->p;
+    float clawDist = cpvlength(cpvsub(clawPos, cpBodyGetPos(player->body)));
+    if (clawDist <= tuning.retractClawDist) {
+        if (retract)
+            playerRetractClaw(player);
+    } else {
+        // prevent the claw from going back out once it goes in
+        float currentLength = cpSlideJointGetMax(&player->slideJoint->constraint);
+        float autoDelta = currentLength - std::max(clawDist, tuning.retractClawDist);
+        float delta = std::max(autoDelta, getPlayerReelInSpeed(player));
+        float newMax = std::max(currentLength - delta, tuning.minClawDist);
+        cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
+
+    }
+}
+
+void World::playerReelOutClawOneFrame(World::Player *player)
+{
+    float currentLength = cpSlideJointGetMax(&player->slideJoint->constraint);
+    float newMax = std::min(currentLength + getPlayerReelInSpeed(player), tuning.maxReelOutLength);
+    cpSlideJointSetMax(&player->slideJoint->constraint, newMax);
+}
+
+float World::getPlayerReelInSpeed(World::Player *player)
+{
+    return (playerState.clawState[player->index] == ClawStateAttached) ? tuning.clawReelInSpeedAttached : tuning.clawReelInSpeedDetached;
+}
+
+void World::addPlatform(cpVect pos, cpVect size, ImageId image, bool canGrapple)
+{
+    createPlatform(pos, size, bundle->getImage(image), canGrapple);
+}
+
+void World::createPlatform(cpVect pos, cpVect size, RuckSackImage *image, bool canGrapple)
+{
+    Platform *platform = new Platform(this);
+
+    platform->image = image;
+    platform->pos = pos;
+    platform->size = size;
+
+    platform->body = cpBodyNewStatic();
+    cpBodySetPos(platform->body, pos);
+    setBodyId(platform->body, platforms.size(), PlatformBody);
+    platform->shape = cpBoxShapeNew(platform->body, size.x, size.y);
+    platform->ident.canGrapple = canGrapple;
+    cpShapeSetUserData(platform->shape, &platform->ident);
+    cpShapeSetFriction(platform->shape, 0.8f);
+    cpSpaceAddShape(space, platform->shape);
+
+    platforms.push_back(platform);
+}
+
+// Players are numbered by their Start objects, so the map decides how many
+// there are.
+void World::initPlayer(int index, cpVect pos)
+{
+    while ((int)players.size() <= index) {
+        players.push_back(new Player(players.size(), this));
+    }
+    playerState.resize(players.size());
+
+    Player *player = players[index];
+    if (player->body) {
+        std::cerr << "more than one start for player " << index << "\n";
+        std::exit(1);
+    }
+    RuckSackImage *imageInfo = bundle->getImage(ImgMan);
+    player->localAnchorPos = cpv(imageInfo->anchor_x, imageInfo->anchor_y);
+    player->size = cpv(imageInfo->width, imageInfo->height);
+
+    RuckSackImage *clawOpenImageInfo = bundle->getImage(ImgClaw);
+    clawRadius = clawOpenImageInfo->width / 2.0f;
+    player->clawLocalAnchorPos = cpv(clawOpenImageInfo->anchor_x, clawOpenImageInfo->anchor_y);
+
+    player->body = cpSpaceAddBody(space, cpBodyNew(20.0f, INFINITY));
+    setBodyId(player->body, index, PlayerBody);
+    cpBodySetPos(player->body, cpv(pos.x, pos.y));
+    player->prevPos = pos;
+    playerState.aimStartPos[index] = cpvadd(pos, cpvmult(playerState.aimUnit[index], armLength));
+    player->prevAimStartPos = playerState.aimStartPos[index];
+
+    player->shape = cpSpaceAddShape(space, cpBoxShapeNew(player->body, player->size.x, player->size.y));
+    cpShapeSetFriction(player->shape, 0.8f);
+
+    cpBB footBB = cpBBNew(
+                -player->size.x / 2.0f + footSensorInset,
+                player->size.y / 2.0f + footSensorTop,
+                player->size.x / 2.0f - footSensorInset,
+                player->size.y / 2.0f + footSensorBottom);
+    player->footShape = cpSpaceAddShape(space, cpBoxShapeNew2(player->body, footBB));
+    cpShapeSetSensor(player->footShape, cpTrue);
+    cpShapeSetCollisionType(player->footShape, FootSensorCollisionType);
+    cpShapeSetUserData(player->footShape, player);
+
+    player->clawBody = cpBodyNew(1.0f, INFINITY);
+    setBodyId(player->clawBody, index, ClawBody);
+    player->clawShape = cpCircleShapeNew(player->clawBody, clawRadius, cpvzero);
+    cpShapeSetFriction(player->clawShape, 0.0f);
+    cpShapeSetElasticity(player->clawShape, 0.0f);
+    cpShapeSetUserData(player->clawShape, &player->clawFixtureUserData);
+
+    player->slideJoint = cpSlideJointAlloc();
+    cpSlideJointInit(player->slideJoint, player->body, player->clawBody,
+                     player->localAnchorPos, player->clawLocalAnchorPos, tuning.minClawDist, tuning.maxReelOutLength);
+    // bodies are filled in when the claw hits something
+    player->pivotJoint = cpPivotJointAlloc();
+    cpPivotJointInit(player->pivotJoint, player->clawBody, player->body, cpvzero, cpvzero);
+}
@@ -0,0 +1,209 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <chipmunk/chipmunk.h>
+
+#include <string>
+#include <vector>
+
+#include "resourcebundle.h"
+
+struct PlayerInput {
+    float xAxis;
+    float yAxis;
+    bool btnJump;
+    bool btnFireGrapple;
+    bool btnUnhookGrapple;
+    bool btnReelOut;
+
+    PlayerInput() {
+        reset();
+    }
+    void reset();
+};
+
+// Gameplay constants. Every world has its own copy, so batch runs can
+// try different values side by side.
+struct Tuning {
+    float maxPlayerSpeed = 200.0f;
+    float playerMoveForceAir = 300.0f;
+    float playerMoveForceGround = 600.0f;
+    float jumpForce = 800.0f;
+    int maxJumpFrames = 14;
+    float clawShootSpeed = 2500.0f;
+    float minClawDist = 50.0f;
+    float retractClawDist = 150.0f;
+    float clawReelInSpeedAttached = 12.0f;
+    float clawReelInSpeedDetached = 20.0f;
+    float jnAccMin = -3000.0f;
+    float maxReelOutLength = 99999999.0f;
+
+    // Sets a field by name. Returns false if there is no such field.
+    bool set(const std::string &name, float value);
+};
+
+// The simulation: chipmunk space, players and platforms. It does no drawing
+// and does not depend on SFML graphics, so it can be stepped without a window.
+class World
+{
+public:
+    enum FixtureIdentType {
+        ClawFixture,
+        PlatformFixture,
+    };
+
+    class Player;
+    struct FixtureIdent {
+        FixtureIdentType type;
+        World *world;
+        Player *player;
+        bool canGrapple;
+    };
+
+    enum ClawState {
+        ClawStateRetracted,
+        ClawStateAir,
+        ClawStateAttached,
+        ClawStateDetached,
+    };
+
+    // The parts of a player that are set up once and only touched through
+    // pointers. What changes every step lives in PlayerState.
+    class Player {
+    public:
+        int index;
+
+        cpBody *clawBody = NULL;
+        cpShape *clawShape = NULL;
+        FixtureIdent clawFixtureUserData;
+        cpVect localAnchorPos;
+        cpVect clawLocalAnchorPos;
+        cpSlideJoint *slideJoint = NULL;
+        cpPivotJoint *pivotJoint = NULL;
+        bool pivotJointActive = false; // queued or in the space
+        bool queuePivotJoint = false;
+
+        cpBody *body = NULL;
+        cpShape *shape = NULL;
+        cpShape *footShape = NULL; // sensor just below the feet
+        cpVect size;
+
+        // state before the last step, so drawing can interpolate
+        cpVect prevPos;
+        cpVect prevClawPos;
+        cpVect prevAimStartPos;
+
+        Player(int index, World *world);
+    };
+
+    // Per-step player fields, one array per field indexed by player, so the
+    // step loop walks memory in order instead of hopping between players.
+    struct PlayerState {
+        std::vector<PlayerInput> input;
+        std::vector<ClawState> clawState;
+        std::vector<float> pointAngle;
+        std::vector<float> facing; // -1 when the last horizontal input was left
+        std::vector<cpVect> aimUnit; // unit vector pointing where aiming
+        std::vector<cpVect> aimStartPos; // where the claw will be created
+        std::vector<int> footContacts;
+        std::vector<int> jumpFrameCount;
+
+        void resize(int count);
+    };
+
+    class Platform {
+    public:
+        // NULL for the collision boxes of tile layers, whose tiles are drawn
+        // instead
+        RuckSackImage *image;
+        cpVect pos;
+        cpVect size;
+        cpShape *shape;
+        cpBody *body;
+        FixtureIdent ident;
+        Platform(World *world);
+    };
+
+    class TileLayer {
+    public:
+        int width; // in tiles
+        int height;
+        bool visible;
+        // row major, NULL where there is no tile
+        std::vector<RuckSackImage *> tiles;
+    };
+
+    World(ResourceBundle *bundle, const Tuning &tuning = Tuning());
+    ~World();
+
+    void loadMap(const std::string &key);
+    void step();
+
+    // for building arenas without a map; players are added as their
+    // index is first seen
+    void addPlatform(cpVect pos, cpVect size, ImageId image, bool canGrapple);
+    void initPlayer(int index, cpVect pos);
+
+    // Copies everything that changes while the game runs, claw joints
+    // included, into one flat buffer that is the same size for the life of
+    // the world. Restoring also throws away chipmunk's cached contacts, so
+    // loadState(saveState()) is not a no-op, and a world that was restored
+    // drifts from one that was not.
+    void saveState(std::vector<unsigned char> &buffer);
+    void loadState(const std::vector<unsigned char> &buffer);
+    // size of a saved state; files that keep them check it on load
+    static size_t stateSize(int playerCount);
+
+    // Hashes of the bits a step changes: every body's position and velocity
+    // and every claw's state. Two runs of the same binary fed the same input
+    // must agree on them at every step. Across builds they only agree if
+    // chipmunk, which is prebuilt, was compiled with the same float flags.
+    unsigned long long checksum() const;
+    unsigned long long playerChecksum(int index) const;
+
+    const Tuning tuning;
+    float timeStep;
+    int stepIndex; // steps since the map was loaded
+    std::string mapKey;
+    float arenaWidth;
+    float arenaHeight;
+    float tileWidth;
+    float tileHeight;
+    float armLength;
+    float clawRadius;
+
+    cpSpace *space;
+    std::vector<Player*> players;
+    PlayerState playerState;
+    std::vector<Platform *> platforms;
+    std::vector<TileLayer *> tileLayers;
+
+private:
+    ResourceBundle *bundle;
+
+    void createPlatform(cpVect pos, cpVect size, RuckSackImage *image, bool canGrapple);
+
+    int bodyToId(cpBody *body);
+    cpBody *idToBody(int id);
+
+    void savePrevState();
+    void stepPlayer(int index);
+
+    void onPostSolveCollision(cpArbiter *arb);
+    void handleClawHit(Player *player, cpArbiter *arb, cpShape *otherShape);
+    void sweepClaw(int index);
+    void playerHookClaw(Player *player);
+    void playerActivateClaw(Player *player, cpVect pos, float angle, cpVect vel);
+    void playerRetractClaw(Player *player);
+    void playerDeactivateClaw(Player *player);
+    void playerUnhookClaw(Player *player);
+    void playerReelClawOneFrame(Player *player, bool retract);
+    void playerReelOutClawOneFrame(Player *player);
+    float getPlayerReelInSpeed(Player *player);
+
+    static cpBool footBeginCallback(cpArbiter *arb, cpSpace *space, void *data);
+    static void footSeparateCallback(cpArbiter *arb, cpSpace *space, void *data);
+    static void postSolveCollisionCallback(cpArbiter *arb, cpSpace *space, void *data);
+};
+
+#endif // WORLD_H